@@ -1,9 +1,199 @@
 #ifndef RING
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <type_traits>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "node_arena.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 #define RING
 
+
+//This macro sets how many nodes ahead of the current one the scanning functions of the Ring class prefetch. It can be defined before including this file.
+#ifndef RING_PREFETCH_DISTANCE
+#define RING_PREFETCH_DISTANCE 4
+#endif
+
+
+//This trait tells whether a type can be hashed with std::hash. It is used by the Ring class to decide whether its elements can take part in the content hash.
+template<typename T, typename = void>
+struct IsHashable : std::false_type{};
+
+template<typename T>
+struct IsHashable<T, decltype(void(std::hash<T>()(std::declval<const T&>())))> : std::true_type{};
+
+
+//This trait tells whether two values of a type can be compared with operator<. It is used by KeyProbe to decide whether keys can be sorted.
+template<typename T, typename = void>
+struct IsLessComparable : std::false_type{};
+
+template<typename T>
+struct IsLessComparable<T, decltype(void(std::declval<const T&>() < std::declval<const T&>()))> : std::true_type{};
+
+
+//This class represents a table of keys which is built once and then probed for every element visited during a single traversal of a Ring, so that many keys can be looked for
+//at once. Repeated keys are stored once, and each distinct key gets a slot number. The way keys are stored is picked from the size of the batch and what the Key type supports:
+//small batches are kept in an array which is searched linearly, larger ones in a hash table if Key can be hashed with std::hash, or else in a sorted array searched with binary search
+//if Key supports operator<. Keys supporting neither are always searched linearly.
+template<typename Key>
+class KeyProbe{
+
+private:
+    enum class Layout{ Linear, Hashed, Sorted };
+
+    typedef typename std::conditional<IsHashable<Key>::value,std::unordered_map<Key,unsigned int>,char>::type HashTable;
+
+    Layout Kind = Layout::Linear;
+    std::vector<Key> Distinct;
+    std::vector<unsigned int> Slots;
+    std::vector<std::pair<Key,unsigned int>> Ordered;
+    HashTable Table;
+
+    int FindLinear(const Key& ID) const{
+        for(unsigned i=0; i<Distinct.size() ;i++) if(Distinct[i] == ID) return i;
+        return -1;
+    }
+
+public:
+
+    //This constant is the largest batch of keys which is always searched linearly.
+    static const unsigned int LinearLimit = 8;
+
+
+    //Constructor
+    explicit KeyProbe(const std::vector<Key>& keys){
+        Slots.reserve(keys.size());
+
+        if constexpr(IsHashable<Key>::value){
+            if(keys.size() > LinearLimit){
+                Kind = Layout::Hashed;
+                Table.reserve(keys.size());
+                for(const Key& ID : keys){
+                    auto inserted = Table.emplace(ID,Distinct.size());
+                    if(inserted.second) Distinct.push_back(ID);
+                    Slots.push_back(inserted.first->second);
+                }
+                return;
+            }
+        }
+
+        if constexpr(IsLessComparable<Key>::value){
+            if(keys.size() > LinearLimit){
+                Kind = Layout::Sorted;
+                Ordered.reserve(keys.size());
+                for(unsigned i=0; i<keys.size() ;i++) Ordered.emplace_back(keys[i],i);
+                std::sort(Ordered.begin(),Ordered.end(),[](const std::pair<Key,unsigned int>& arg1, const std::pair<Key,unsigned int>& arg2){ return arg1.first < arg2.first; });
+                Slots.resize(keys.size());
+                std::vector<std::pair<Key,unsigned int>> Merged;
+                for(const auto& entry : Ordered){
+                    if(Merged.empty() || Merged.back().first < entry.first){
+                        Merged.emplace_back(entry.first,Distinct.size());
+                        Distinct.push_back(entry.first);
+                    }
+                    Slots[entry.second] = Merged.back().second;
+                }
+                Ordered.swap(Merged);
+                return;
+            }
+        }
+
+        for(const Key& ID : keys){
+            int found = this->FindLinear(ID);
+            if(found < 0){
+                found = Distinct.size();
+                Distinct.push_back(ID);
+            }
+            Slots.push_back(found);
+        }
+    }
+
+
+    //This function returns the slot of the given key, or -1 if the key is not in the table.
+    int Find(const Key& ID) const{
+        if constexpr(IsHashable<Key>::value){
+            if(Kind == Layout::Hashed){
+                auto found = Table.find(ID);
+                return found == Table.end() ? -1 : static_cast<int>(found->second);
+            }
+        }
+        if constexpr(IsLessComparable<Key>::value){
+            if(Kind == Layout::Sorted){
+                auto found = std::lower_bound(Ordered.begin(),Ordered.end(),ID,[](const std::pair<Key,unsigned int>& entry, const Key& item){ return entry.first < item; });
+                return (found == Ordered.end() || ID < found->first) ? -1 : static_cast<int>(found->second);
+            }
+        }
+        return this->FindLinear(ID);
+    }
+
+
+    //This function returns the number of distinct keys in the table.
+    unsigned int Count() const{ return Distinct.size(); }
+
+
+    //This function returns the slot of the key at the given position of the batch the table was built from.
+    unsigned int SlotOf(unsigned int position) const{ return Slots[position]; }
+
+};
+
+
+//This structure tells how many bytes a value owns on the heap besides the bytes of the value itself. It's used by Ring::MemoryUsage to count the payloads of keys and infos.
+//The general version assumes nothing is owned, so types owning heap memory need a specialization with the same function, like the ones for std::string and std::vector below.
+template<typename T>
+struct PayloadSize{
+    static size_t Of(const T&){ return 0; }
+};
+
+
+//This specialization counts the buffer of a string, unless the string is short enough to be stored inside the string object itself.
+template<typename CharT, typename Traits, typename Alloc>
+struct PayloadSize<std::basic_string<CharT,Traits,Alloc>>{
+    static size_t Of(const std::basic_string<CharT,Traits,Alloc>& item){
+        const char* inside = reinterpret_cast<const char*>(&item);
+        const char* buffer = reinterpret_cast<const char*>(item.data());
+        if(buffer >= inside && buffer < inside + sizeof(item)) return 0;
+        return (item.capacity() + 1) * sizeof(CharT);
+    }
+};
+
+
+//This specialization counts the buffer of a vector along with the payloads of its elements.
+template<typename T, typename Alloc>
+struct PayloadSize<std::vector<T,Alloc>>{
+    static size_t Of(const std::vector<T,Alloc>& item){
+        size_t Bytes = item.capacity() * sizeof(T);
+        for(const T& element : item) Bytes += PayloadSize<T>::Of(element);
+        return Bytes;
+    }
+};
+
+
+//This structure holds the number of bytes a Ring occupies, as returned by Ring::MemoryUsage.
+struct RingMemory{
+    //The bytes of all the nodes, including the sentinel.
+    size_t NodeBytes = 0;
+    //The bytes the keys and infos own on the heap, as told by PayloadSize.
+    size_t PayloadBytes = 0;
+    //The bytes the allocator spends on the nodes beyond their size: the rounding and headers of the heap, or the rounding of a NodeArena.
+    size_t SlackBytes = 0;
+
+    //This function returns the total number of bytes.
+    size_t Total() const{ return NodeBytes + PayloadBytes + SlackBytes; }
+};
+
+
 //This class represents a doubly linked list implemented as a Ring where the Last element Leads back to the start, and where it's possible to move directly from the start to the last element.
 //This implementation of the linked lists uses a sentinel node at the beginning which is given default key and info values. The sentinel is in practice the first element in the list but can
 //be treated as a non-existent element due to the methods of this class allowing for list manipulation and reading without accessing or interacting with this sentinel node.
@@ -19,10 +209,62 @@ private:
 
 
         Node(const Key& ID = Key(), const Info& data = Info(), Node* consq = nullptr, Node* prec = nullptr) : label(ID), value(data), next(consq), prev(prec){}
+        Node(Key&& ID, Info&& data, Node* consq, Node* prec) : label(std::move(ID)), value(std::move(data)), next(consq), prev(prec){}
     };
 
     Node* start = nullptr;
     unsigned int Size = 0;
+    NodeArena* Arena = nullptr;
+
+public:
+    class Observer;
+
+private:
+    std::vector<Observer*> Observers;
+
+    template<typename Call>
+    void Notify(Call call){
+        for(Observer* watcher : Observers) call(watcher);
+    }
+
+    template<typename... Args>
+    Node* MakeNode(Args&&... args){
+        if(!Arena) return new Node(std::forward<Args>(args)...);
+        void* block = Arena->Allocate(sizeof(Node),alignof(Node));
+        try{
+            return new (block) Node(std::forward<Args>(args)...);
+        }
+        catch(...){
+            Arena->Deallocate(block,sizeof(Node));
+            throw;
+        }
+    }
+
+    static void Prefetch(const Node* item){
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(item);
+#else
+        (void)item;
+#endif
+    }
+
+    template<typename Visit>
+    static Node* Walk(Node* from, Node* to, Visit visit);
+
+    template<typename Visit>
+    static Node* WalkBoth(Node* sentinel, unsigned int count, Visit visit);
+
+    static void DestroyNode(Node* item, NodeArena* from){
+        if(!from) delete item;
+        else{
+            item->~Node();
+            from->Deallocate(item,sizeof(Node));
+        }
+    }
+
+    static size_t HashOf(const Key& ID, const Info& Data);
+
+    static size_t SlackOf(Node* item, NodeArena* from);
 
 public:
 
@@ -142,14 +384,14 @@ public:
         bool operator!=(const ConstIterator& other) const{ return cpointer != other.cpointer; }
 
 
-        //This operator returns the key of the element the iterator points to.
-        Info operator*() const{
+        //This operator returns the info of the element the iterator points to.
+        const Info& operator*() const{
             return cpointer->value;
         }
 
 
-        //This operator returns the info of the element the iterator points to.
-        Key operator&() const{
+        //This operator returns the key of the element the iterator points to.
+        const Key& operator&() const{
             return cpointer->label;
         }
 
@@ -160,25 +402,159 @@ public:
     };
 
 
+    //This class represents a persistent read-only position in the Ring which moves through it cyclically. Unlike the iterators, moving a cursor past the last element
+    //takes it directly to the first element and the other way around, so the sentinel is never visited unless the Ring is empty. A cursor stays valid as long as the element
+    //it points to is not removed from the Ring.
+    class Cursor{
+
+    private:
+        Node* cpointer;
+        Node* sentinel;
+        Cursor(Node* P, Node* S) : cpointer(P), sentinel(S){}
+        friend class Ring;
+
+    public:
+
+        //This operator moves the cursor to the element after the element currently pointed to, skipping the sentinel. It returns the cursor after moving it.
+        Cursor& operator++(){
+            cpointer = cpointer->next;
+            if(cpointer == sentinel) cpointer = cpointer->next;
+            return *this;
+        }
+
+
+        //This operator moves the cursor to the element previous to the element currently pointed to, skipping the sentinel. It returns the cursor after moving it.
+        Cursor& operator--(){
+            cpointer = cpointer->prev;
+            if(cpointer == sentinel) cpointer = cpointer->prev;
+            return *this;
+        }
+
+
+        //This operator returns true if two cursors point to the same element and false otherwise.
+        bool operator==(const Cursor& other) const{ return cpointer == other.cpointer; }
+
+
+        //This operator returns false if two cursors point to the same element and true otherwise.
+        bool operator!=(const Cursor& other) const{ return cpointer != other.cpointer; }
+
+
+        //This operator returns the info of the element the cursor points to.
+        const Info& operator*() const{ return cpointer->value; }
+
+
+        //This operator returns the key of the element the cursor points to.
+        const Key& operator&() const{ return cpointer->label; }
+
+
+        //This function returns an iterator pointing to the element the cursor points to.
+        Iterator Position() const{ return cpointer; }
+
+
+        //This function returns true if the cursor points to the sentinel, which only happens while the Ring is empty, and false otherwise.
+        bool IsSentinel() const{ return cpointer == sentinel; }
+
+    };
+
+
+    //This class represents an object which is told about every change made to the elements of a Ring it's subscribed to. Each function is called by the Ring right after
+    //(or, for removals and moves, right before) the change it reports, and does nothing by default. Rebalance and Compact only move elements in memory, so they are only
+    //reported through Relocated. Observers must not subscribe or unsubscribe from within these functions.
+    class Observer{
+
+    public:
+
+        //Destructor
+        virtual ~Observer(){}
+
+
+        //This function is called after an element was added to the Ring by PushFront, PushBack or Insert.
+        virtual void Inserted(const Iterator&){}
+
+
+        //This function is called before an element is removed from the Ring by PopFront, PopBack or Erase, while it can still be read.
+        virtual void Erasing(const Iterator&){}
+
+
+        //This function is called after the info of an element was changed by Update, with the info it had before.
+        virtual void Updated(const Iterator&, const Info&){}
+
+
+        //This function is called after all the elements were removed from the Ring by Clear.
+        virtual void Cleared(){}
+
+
+        //This function is called before an element other than the first one is moved to the beginning of the Ring by Touch.
+        virtual void Touching(const Iterator&){}
+
+
+        //This function is called before the Ring is rotated by Rotate or RotateTo so that an element other than the first one becomes the first element.
+        virtual void Rotating(const Iterator&){}
+
+
+        //This function is called after Rebalance or Compact moved the elements into new nodes, so the iterators to the Ring the observer kept are no longer valid.
+        virtual void Relocated(){}
+
+
+        //This function is called when the Ring is destroyed. The observer is unsubscribed afterwards.
+        virtual void Detached(){}
+
+    };
+
+
+private:
+
+    std::vector<Iterator> Expand(const KeyProbe<Key>& probe, const std::vector<Node*>& found, unsigned int count) const;
+
+public:
+
     //Constructor
-    Ring(){
-        start = new Node();
+    Ring() : Ring(nullptr){}
+
+
+    //Constructor. The nodes of the Ring, including the sentinel, are allocated from the given arena, or from the global heap if it's nullptr.
+    explicit Ring(NodeArena* arena) : Arena(arena){
+        start = this->MakeNode();
         start->next = start;
         start->prev = start;
     }
 
 
-    //Copy constructor
-    Ring(const Ring& src){ *this = src; }
+    //Copy constructor. The copy allocates its nodes from the same arena as the source.
+    Ring(const Ring& src) : Ring(src.Arena){ *this = src; }
 
 
     //Destructor
     ~Ring(){
+        this->Notify([](Observer* watcher){ watcher->Detached(); });
+        Observers.clear();
         this->Clear();
-        delete start;
+        DestroyNode(start,Arena);
+    }
+
+
+    //This function subscribes an observer to the changes made to the Ring. Observers are not copied along with the Ring.
+    void Subscribe(Observer* watcher){
+        assert(watcher);
+        Observers.push_back(watcher);
+    }
+
+
+    //This function unsubscribes an observer from the changes made to the Ring. It does nothing if the observer was not subscribed.
+    void Unsubscribe(Observer* watcher){
+        for(unsigned i=0; i<Observers.size() ;i++){
+            if(Observers[i] == watcher){
+                Observers.erase(Observers.begin() + i);
+                return;
+            }
+        }
     }
 
 
+    //This function returns the arena the nodes of the Ring are allocated from, or nullptr if they are allocated from the global heap.
+    NodeArena* GetArena() const{ return Arena; }
+
+
     //This function returns an iterator pointing to the first element in the Ring (the element after the sentinel.
     Iterator GetFirst() const{
         assert(start);
@@ -193,6 +569,17 @@ public:
     }
 
 
+    //This function returns a cursor pointing to the first element in the Ring, or to the sentinel if the Ring is empty.
+    Cursor GetCursor() const{ return Cursor(start->next,start); }
+
+
+    //This function returns a cursor pointing to the element that the iterator passed to it points to. If that element is the sentinel the cursor is moved to the first element.
+    Cursor GetCursor(const Iterator& item) const{
+        assert(item.pointer);
+        return item.pointer == start ? Cursor(start->next,start) : Cursor(item.pointer,start);
+    }
+
+
     //This function returns the number of elements currently present in the Ring.
     unsigned int Length() const{ return Size; }
 
@@ -203,8 +590,9 @@ public:
 
     //This function inserts an element with a given key and info to the beginning of the Ring.
     Iterator PushFront(const Key& ID, const Info& Data){
-        start->next = start->next->prev = new Node(ID,Data,start->next,start);
+        start->next = start->next->prev = this->MakeNode(ID,Data,start->next,start);
         Size++;
+        this->Notify([this](Observer* watcher){ watcher->Inserted(start->next); });
         return this->GetFirst();
     }
 
@@ -213,9 +601,10 @@ public:
     Iterator PopFront(){
         if(!this->IsEmpty()){
             Iterator temp = start->next;
+            this->Notify([&temp](Observer* watcher){ watcher->Erasing(temp); });
             start->next = start->next->next;
             start->next->prev = start;
-            delete temp.pointer;
+            DestroyNode(temp.pointer,Arena);
             Size--;
         }
         return this->GetFirst();
@@ -224,8 +613,9 @@ public:
 
     //This function inserts an element with a given key and info to the end of the Ring.
     Iterator PushBack(const Key& ID, const Info& Data){
-        start->prev = start->prev->next = new Node(ID,Data,start,start->prev);
+        start->prev = start->prev->next = this->MakeNode(ID,Data,start,start->prev);
         Size++;
+        this->Notify([this](Observer* watcher){ watcher->Inserted(start->prev); });
         return this->GetLast();
     }
 
@@ -234,9 +624,10 @@ public:
     Iterator PopBack(){
         if(!this->IsEmpty()){
             Iterator temp = start->prev;
+            this->Notify([&temp](Observer* watcher){ watcher->Erasing(temp); });
             start->prev = start->prev->prev;
             start->prev->next = start;
-            delete temp.pointer;
+            DestroyNode(temp.pointer,Arena);
             Size--;
         }
         return this->GetLast();
@@ -244,6 +635,11 @@ public:
 
 
 
+    template<typename Visit>
+    void Scan(Visit visit) const;
+
+
+
     Iterator LookFor(const Key& item) const;
 
 
@@ -252,6 +648,14 @@ public:
 
 
 
+    std::vector<Iterator> LookForMany(const std::vector<Key>& keys, bool parallel = false) const;
+
+
+
+    std::vector<Iterator> LookThroughMany(const std::vector<Key>& keys, const Iterator& Begin, const Iterator& End) const;
+
+
+
     Iterator Insert(const Iterator& item, const Key& ID, const Info& Data);
 
 
@@ -260,6 +664,38 @@ public:
 
 
 
+    Iterator Touch(const Iterator& item);
+
+
+
+    Iterator Rotate(int count);
+
+
+
+    Iterator RotateTo(const Iterator& item);
+
+
+
+    Iterator Update(const Iterator& item, const Info& Data);
+
+
+
+    size_t ContentHash() const;
+
+
+
+    void Rebalance(NodeArena* arena);
+
+
+
+    void Compact();
+
+
+
+    RingMemory MemoryUsage() const;
+
+
+
     void Clear();
 
 
@@ -276,42 +712,203 @@ public:
 
 
 
-    bool operator==(const Ring& other);
+    bool operator==(const Ring& other) const;
 
 
 
-    bool operator!=(const Ring& other);
+    bool operator!=(const Ring& other) const;
 
 };
 
 
-//This function searches the whole ring for an element with a given key. If the element is found then an iterator to it is returned, otherwise nullptr is returned.
+//This function is the traversal kernel shared by the scanning functions of the Ring. It goes forward from the node from up to, but not including, the node to, calling visit
+//on every node until visit returns true, and returns that node, or nullptr if visit never returned true. A second pointer runs RING_PREFETCH_DISTANCE nodes ahead and prefetches
+//the node it reaches, so the nodes are already on their way into the cache by the time visit reaches them.
 template<typename Key, typename Info>
-typename Ring<Key,Info>::Iterator Ring<Key,Info>::LookFor(const Key& item) const{
-    Iterator temp = start;
+template<typename Visit>
+typename Ring<Key,Info>::Node* Ring<Key,Info>::Walk(Node* from, Node* to, Visit visit){
+    Node* ahead = from;
+    for(unsigned i=0; i<RING_PREFETCH_DISTANCE && ahead != to ;i++){
+        ahead = ahead->next;
+        Prefetch(ahead);
+    }
 
-    do{
-        if(temp.pointer->label == item) return temp;
-        ++temp;
-    }while(temp != start);
+    for(Node* temp = from; temp != to ;temp = temp->next){
+        if(ahead != to){
+            ahead = ahead->next;
+            Prefetch(ahead);
+        }
+        if(visit(temp)) return temp;
+    }
 
     return nullptr;
 }
 
+
+//This function is the two-ended version of Walk. It goes through the count elements after the sentinel with one cursor moving forward from the first element and another
+//moving backward from the last element, one step of each at a time, until they meet in the middle. This keeps two independent chains of loads in flight, which roughly halves
+//the time spent waiting on memory. It returns the first node in forward order for which visit returns true, or nullptr if there is none. A match in the front half is returned
+//right away, while a match in the back half is only returned once the cursors meet, since an earlier match may still be found in the front half.
+template<typename Key, typename Info>
+template<typename Visit>
+typename Ring<Key,Info>::Node* Ring<Key,Info>::WalkBoth(Node* sentinel, unsigned int count, Visit visit){
+    unsigned int FrontCount = (count + 1) / 2;
+    unsigned int BackCount = count - FrontCount;
+    Node* front = sentinel->next;
+    Node* back = sentinel->prev;
+    Node* aheadFront = front;
+    Node* aheadBack = back;
+    Node* found = nullptr;
+
+    for(unsigned i=0; i<RING_PREFETCH_DISTANCE ;i++){
+        aheadFront = aheadFront->next;
+        aheadBack = aheadBack->prev;
+        Prefetch(aheadFront);
+        Prefetch(aheadBack);
+    }
+
+    for(unsigned i=0; i<FrontCount ;i++){
+        aheadFront = aheadFront->next;
+        Prefetch(aheadFront);
+        if(visit(front)) return front;
+        front = front->next;
+
+        if(i < BackCount){
+            aheadBack = aheadBack->prev;
+            Prefetch(aheadBack);
+            if(visit(back)) found = back;
+            back = back->prev;
+        }
+    }
+
+    return found;
+}
+
+
+//This function calls visit with the key and info of every element of the Ring in order, through the prefetching traversal kernel.
+template<typename Key, typename Info>
+template<typename Visit>
+void Ring<Key,Info>::Scan(Visit visit) const{
+    Walk(start->next,start,[&visit](Node* temp){
+        visit(static_cast<const Key&>(temp->label),static_cast<const Info&>(temp->value));
+        return false;
+    });
+}
+
+
+//This function searches the whole ring for an element with a given key. If the element is found then an iterator to it is returned, otherwise nullptr is returned.
+//The elements are searched from both ends at once, but the element returned is still the first one with the given key.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator Ring<Key,Info>::LookFor(const Key& item) const{
+    if(start->label == item) return start;
+    return WalkBoth(start,Size,[&item](Node* temp){ return temp->label == item; });
+}
+
 //This function searches within a given range for a given key in the Ring. If the element is found then an iterator to it is returned, otherwise nullptr is returned.
 template<typename Key, typename Info>
 typename Ring<Key,Info>::Iterator Ring<Key,Info>::LookThrough(const Key& item, const Iterator& Begin, const Iterator& End) const{
-    Iterator temp = Begin;
     if( Begin != nullptr && End != nullptr){
+        if(Begin.pointer->label == item) return Begin;
+        if(Begin != End) return Walk(Begin.pointer->next,End.pointer,[&item](Node* temp){ return temp->label == item; });
+        return Walk(Begin.pointer->next,Begin.pointer,[&item](Node* temp){ return temp->label == item; });
+    }
+
+    return nullptr;
+}
 
-    do{
-        if(temp.pointer->label == item) return temp;
-        ++temp;
-    }while(temp != End);
 
+//This function looks for every key of a batch in the whole Ring at once. The result holds, for each key of the batch, the same iterator LookFor would return for it, but the Ring
+//is only traversed once, and the traversal stops as soon as every distinct key was found. If parallel is true and the Ring is large enough to be worth it, a second thread goes
+//through the back half of the Ring backwards while the calling thread goes through the front half, as in WalkBoth. Once the front half has found every key, the second thread
+//stops within 64 nodes, since a key found in the front half always comes first. The Ring must not be changed while this runs.
+template<typename Key, typename Info>
+std::vector<typename Ring<Key,Info>::Iterator> Ring<Key,Info>::LookForMany(const std::vector<Key>& keys, bool parallel) const{
+    const unsigned int ParallelLimit = 1 << 16;
+    KeyProbe<Key> probe(keys);
+    std::vector<Node*> found(probe.Count(),nullptr);
+    unsigned int Remaining = probe.Count();
+
+    int slot = probe.Find(start->label);
+    if(slot >= 0){
+        found[slot] = start;
+        --Remaining;
+    }
+    if(Remaining == 0) return this->Expand(probe,found,keys.size());
+
+    if(!parallel || Size < ParallelLimit){
+        Walk(start->next,start,[&probe,&found,&Remaining](Node* temp){
+            int slot = probe.Find(temp->label);
+            if(slot < 0 || found[slot]) return false;
+            found[slot] = temp;
+            return --Remaining == 0;
+        });
+        return this->Expand(probe,found,keys.size());
     }
 
-    return nullptr;
+    unsigned int FrontCount = (Size + 1) / 2;
+    unsigned int BackCount = Size - FrontCount;
+    std::vector<Node*> foundBack(probe.Count(),nullptr);
+    std::atomic<bool> FrontDone(false);
+
+    std::thread BackHalf([this,&probe,&foundBack,&FrontDone,BackCount](){
+        Node* ahead = start->prev;
+        for(unsigned i=0; i<RING_PREFETCH_DISTANCE ;i++) ahead = ahead->prev;
+        Node* temp = start->prev;
+        for(unsigned i=0; i<BackCount ;i++,temp = temp->prev){
+            if(i % 64 == 0 && FrontDone.load(std::memory_order_relaxed)) return;
+            ahead = ahead->prev;
+            Prefetch(ahead);
+            int slot = probe.Find(temp->label);
+            if(slot >= 0) foundBack[slot] = temp;
+        }
+    });
+
+    unsigned int Visited = 0;
+    Walk(start->next,start,[&probe,&found,&Remaining,&Visited,&FrontDone,FrontCount](Node* temp){
+        if(Visited++ == FrontCount) return true;
+        int slot = probe.Find(temp->label);
+        if(slot < 0 || found[slot]) return false;
+        found[slot] = temp;
+        if(--Remaining != 0) return false;
+        FrontDone.store(true,std::memory_order_relaxed);
+        return true;
+    });
+    BackHalf.join();
+
+    for(unsigned i=0; i<found.size() ;i++) if(!found[i]) found[i] = foundBack[i];
+    return this->Expand(probe,found,keys.size());
+}
+
+
+//This function looks for every key of a batch within a given range of the Ring at once. The result holds, for each key of the batch, the same iterator LookThrough would return
+//for it, but the range is only traversed once, and the traversal stops as soon as every distinct key was found.
+template<typename Key, typename Info>
+std::vector<typename Ring<Key,Info>::Iterator> Ring<Key,Info>::LookThroughMany(const std::vector<Key>& keys, const Iterator& Begin, const Iterator& End) const{
+    KeyProbe<Key> probe(keys);
+    std::vector<Node*> found(probe.Count(),nullptr);
+
+    if( Begin != nullptr && End != nullptr && probe.Count() > 0){
+        unsigned int Remaining = probe.Count();
+        auto visit = [&probe,&found,&Remaining](Node* temp){
+            int slot = probe.Find(temp->label);
+            if(slot < 0 || found[slot]) return false;
+            found[slot] = temp;
+            return --Remaining == 0;
+        };
+        if(!visit(Begin.pointer)) Walk(Begin.pointer->next,Begin != End ? End.pointer : Begin.pointer,visit);
+    }
+
+    return this->Expand(probe,found,keys.size());
+}
+
+
+//This function turns the nodes found for each distinct key of a batch into one iterator for each key of the batch, in the order of the batch.
+template<typename Key, typename Info>
+std::vector<typename Ring<Key,Info>::Iterator> Ring<Key,Info>::Expand(const KeyProbe<Key>& probe, const std::vector<Node*>& found, unsigned int count) const{
+    std::vector<Iterator> Result;
+    Result.reserve(count);
+    for(unsigned i=0; i<count ;i++) Result.push_back(found[probe.SlotOf(i)]);
+    return Result;
 }
 
 
@@ -320,10 +917,11 @@ typename Ring<Key,Info>::Iterator Ring<Key,Info>::LookThrough(const Key& item, c
 template<typename Key, typename Info>
 typename Ring<Key,Info>::Iterator Ring<Key,Info>::Insert(const Iterator& item, const Key& ID, const Info& Data){
     if(item.pointer){
-        Iterator NewNode = new Node(ID,Data,item.pointer,item.pointer->prev);
+        Iterator NewNode = this->MakeNode(ID,Data,item.pointer,item.pointer->prev);
         item.pointer->prev->next = NewNode.pointer;
         item.pointer->prev = NewNode.pointer;
         Size++;
+        this->Notify([&NewNode](Observer* watcher){ watcher->Inserted(NewNode); });
         return NewNode;
     }
     return nullptr;
@@ -337,9 +935,10 @@ typename Ring<Key,Info>::Iterator Ring<Key,Info>::Erase(const Iterator& item){
     if(item.pointer != nullptr && item != start){
         Iterator temp = item;
         Iterator ToBeReturned = temp.pointer->prev;
+        this->Notify([&temp](Observer* watcher){ watcher->Erasing(temp); });
         item.pointer->prev->next = item.pointer->next;
         item.pointer->next->prev = item.pointer->prev;
-        delete temp.pointer;
+        DestroyNode(temp.pointer,Arena);
         Size--;
         return ToBeReturned;
     }
@@ -347,10 +946,297 @@ typename Ring<Key,Info>::Iterator Ring<Key,Info>::Erase(const Iterator& item){
 }
 
 
+//This function moves the element that the iterator passed to it points to, to the beginning of the Ring by relinking it in place, so no element is copied or reallocated.
+//It returns an iterator to the moved element, or nullptr if the passed iterator is null or if it points to the sentinel.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator Ring<Key,Info>::Touch(const Iterator& item){
+    if(item.pointer != nullptr && item != start){
+        if(item.pointer != start->next){
+            this->Notify([&item](Observer* watcher){ watcher->Touching(item); });
+            item.pointer->prev->next = item.pointer->next;
+            item.pointer->next->prev = item.pointer->prev;
+            item.pointer->next = start->next;
+            item.pointer->prev = start;
+            start->next->prev = item.pointer;
+            start->next = item.pointer;
+        }
+        return item;
+    }
+    return nullptr;
+}
+
+
+//This function rotates the Ring by count elements, so that the first count elements become the last ones (or the last -count elements become the first ones if count is
+//negative). It gives the same result as count many PopFront and PushBack pairs, but only the sentinel is relinked, after O(min(count, Length - count)) steps to find its
+//new place. It returns an iterator to the new first element.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator Ring<Key,Info>::Rotate(int count){
+    if(Size < 2) return this->GetFirst();
+    long long steps = count % static_cast<long long>(Size);
+    if(steps < 0) steps += Size;
+    if(steps == 0) return this->GetFirst();
+
+    Node* temp;
+    if(steps <= Size / 2){
+        temp = start->next;
+        for(long long i=0; i<steps ;i++) temp = temp->next;
+    }
+    else{
+        temp = start->prev;
+        for(long long i=Size-1; i>steps ;i--) temp = temp->prev;
+    }
+
+    return this->RotateTo(temp);
+}
+
+
+//This function rotates the Ring so that the element that the iterator passed to it points to becomes the first element. Only the sentinel is relinked, so this takes O(1).
+//It returns an iterator to the new first element, or nullptr if the passed iterator is null or if it points to the sentinel.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator Ring<Key,Info>::RotateTo(const Iterator& item){
+    if(item.pointer != nullptr && item != start){
+        if(item.pointer != start->next){
+            this->Notify([&item](Observer* watcher){ watcher->Rotating(item); });
+            start->prev->next = start->next;
+            start->next->prev = start->prev;
+            start->next = item.pointer;
+            start->prev = item.pointer->prev;
+            item.pointer->prev->next = start;
+            item.pointer->prev = start;
+        }
+        return item;
+    }
+    return nullptr;
+}
+
+
+//This function moves every element of the Ring, including the sentinel, into new nodes allocated from the given arena (or from the global heap if it's nullptr) in traversal
+//order, and frees the old nodes. The Ring keeps using that arena afterwards. Since an arena hands out consecutive blocks, this places elements that follow each other in
+//the Ring next to each other in memory, and on the NUMA node of the arena. Keys and infos are moved, not copied. All iterators and cursors to the Ring are invalidated, and
+//observers are told through Relocated.
+//If the new sentinel can't be built, the Ring is left as it was. If building a node fails after that, the Ring keeps the elements moved so far, in order, in the new arena,
+//and the old nodes are freed. Either way the exception is passed on.
+template<typename Key, typename Info>
+void Ring<Key,Info>::Rebalance(NodeArena* arena){
+    NodeArena* OldArena = Arena;
+    Node* OldStart = start;
+    Arena = arena;
+
+    try{
+        start = this->MakeNode(std::move(OldStart->label),std::move(OldStart->value),nullptr,nullptr);
+    }
+    catch(...){
+        Arena = OldArena;
+        throw;
+    }
+    start->next = start;
+    start->prev = start;
+
+    auto FreeOld = [OldStart,OldArena](){
+        Node* temp = OldStart->next;
+        while(temp != OldStart){
+            Node* following = temp->next;
+            DestroyNode(temp,OldArena);
+            temp = following;
+        }
+        DestroyNode(OldStart,OldArena);
+    };
+
+    unsigned int Rebuilt = 0;
+    try{
+        for(Node* temp = OldStart->next; temp != OldStart ;temp = temp->next){
+            start->prev = start->prev->next = this->MakeNode(std::move(temp->label),std::move(temp->value),start,start->prev);
+            Rebuilt++;
+        }
+    }
+    catch(...){
+        FreeOld();
+        Size = Rebuilt;
+        this->Notify([](Observer* watcher){ watcher->Relocated(); });
+        throw;
+    }
+
+    FreeOld();
+    this->Notify([](Observer* watcher){ watcher->Relocated(); });
+}
+
+
+//This function rebuilds the Ring into freshly allocated nodes in traversal order, to undo the fragmentation left by adding and removing many elements. Unlike Rebalance,
+//every old node is freed before the new elements are allocated, so the new nodes don't just take the places of the scattered old ones: the NodeArena of the Ring releases the
+//chunks left without any block in use to the system and carves the new nodes out of fresh chunks, and the heap is consolidated and trimmed with malloc_trim (on glibc) before
+//and after. Keys and infos are moved into a temporary vector in between, so it takes O(n) extra memory for a moment. A NodeArena shared with other Rings can only release the
+//chunks none of them uses, so the new nodes may reuse freed blocks of the others. Only the new sentinel is allocated up front, so the Ring always has one, from a new chunk of
+//the NodeArena (see NodeArena::AllocateFresh) so that it doesn't keep one of the old chunks in use.
+//If moving an element out throws, the elements moved out before it are dropped and the Ring keeps the rest. If allocating a new node fails, the Ring keeps the elements
+//rebuilt so far, in order. Either way the exception is passed on.
+//All iterators and cursors to the Ring are invalidated, and observers are told through Relocated, also when the rebuild failed.
+template<typename Key, typename Info>
+void Ring<Key,Info>::Compact(){
+    std::vector<std::pair<Key,Info>> Elements;
+    Elements.reserve(Size);
+    Node* Fresh = nullptr;
+    if(!Arena) Fresh = this->MakeNode();
+    else{
+        void* block = Arena->AllocateFresh(sizeof(Node),alignof(Node));
+        try{
+            Fresh = new (block) Node();
+        }
+        catch(...){
+            Arena->Deallocate(block,sizeof(Node));
+            throw;
+        }
+    }
+    Fresh->next = Fresh;
+    Fresh->prev = Fresh;
+    Node* temp = start->next;
+    try{
+        while(temp != start){
+            Elements.emplace_back(std::move(temp->label),std::move(temp->value));
+            temp = temp->next;
+        }
+    }
+    catch(...){
+        Node* moved = start->next;
+        while(moved != temp){
+            Node* following = moved->next;
+            DestroyNode(moved,Arena);
+            moved = following;
+        }
+        start->next = temp;
+        temp->prev = start;
+        Size -= Elements.size();
+        DestroyNode(Fresh,Arena);
+        this->Notify([](Observer* watcher){ watcher->Relocated(); });
+        throw;
+    }
+
+    temp = start->next;
+    while(temp != start){
+        Node* following = temp->next;
+        DestroyNode(temp,Arena);
+        temp = following;
+    }
+    DestroyNode(start,Arena);
+    start = Fresh;
+
+    if(Arena) Arena->Trim();
+#if defined(__GLIBC__)
+    else malloc_trim(0);
+#endif
+
+    unsigned int Rebuilt = 0;
+    try{
+        for(std::pair<Key,Info>& element : Elements){
+            start->prev = start->prev->next = this->MakeNode(std::move(element.first),std::move(element.second),start,start->prev);
+            Rebuilt++;
+        }
+    }
+    catch(...){
+        Size = Rebuilt;
+        this->Notify([](Observer* watcher){ watcher->Relocated(); });
+        throw;
+    }
+    this->Notify([](Observer* watcher){ watcher->Relocated(); });
+
+    std::vector<std::pair<Key,Info>>().swap(Elements);
+#if defined(__GLIBC__)
+    if(!Arena) malloc_trim(0);
+#endif
+}
+
+
+//This function returns the number of bytes the Ring occupies: its nodes, the heap memory owned by its keys and infos, and what the allocator spends on the nodes beyond
+//their size. The payloads are counted by going through the whole Ring, so it takes O(n). The heap slack is only known on glibc and counted as 0 elsewhere, and the free
+//blocks and unused chunks of a NodeArena are not counted, since the arena may be shared (see NodeArena::ReservedBytes and NodeArena::UsedBytes).
+template<typename Key, typename Info>
+RingMemory Ring<Key,Info>::MemoryUsage() const{
+    RingMemory Usage;
+    Usage.NodeBytes = (static_cast<size_t>(Size) + 1) * sizeof(Node);
+    Usage.SlackBytes = SlackOf(start,Arena);
+    Walk(start->next,start,[&Usage,this](Node* item){
+        Usage.PayloadBytes += PayloadSize<Key>::Of(item->label) + PayloadSize<Info>::Of(item->value);
+        Usage.SlackBytes += SlackOf(item,Arena);
+        return false;
+    });
+    return Usage;
+}
+
+
+//This function returns the number of bytes the allocator spends on a node beyond its size.
+template<typename Key, typename Info>
+size_t Ring<Key,Info>::SlackOf(Node* item, NodeArena* from){
+    if(from) return NodeArena::BlockSize(sizeof(Node)) - sizeof(Node);
+#if defined(__GLIBC__)
+    return malloc_usable_size(item) + sizeof(size_t) - sizeof(Node);
+#else
+    (void)item;
+    return 0;
+#endif
+}
+
+
+//This function sets the info of the element that the iterator passed to it points to, telling the observers of the Ring, and returns an iterator to it.
+//It returns nullptr if the passed iterator is null or if it points to the sentinel.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator Ring<Key,Info>::Update(const Iterator& item, const Info& Data){
+    if(item.pointer != nullptr && item != start){
+        if(Observers.empty()) item.pointer->value = Data;
+        else{
+            Info Old = item.pointer->value;
+            item.pointer->value = Data;
+            this->Notify([&item,&Old](Observer* watcher){ watcher->Updated(item,Old); });
+        }
+        return item;
+    }
+    return nullptr;
+}
+
+
+//This function returns a hash of the contents of the Ring, computed from the elements in order, so Rings which are equal always have the same hash, even after elements were
+//written to directly through Iterator::pointer. It goes through the whole Ring, so it takes O(n). It's always 0 if either Key or Info can't be hashed with std::hash.
+template<typename Key, typename Info>
+size_t Ring<Key,Info>::ContentHash() const{
+    size_t Hash = 0;
+    Walk(start->next,start,[&Hash](Node* item){
+        Hash = Hash * 0x100000001B3ULL + HashOf(item->label,item->value);
+        return false;
+    });
+    return Hash;
+}
+
+
+//This function returns the hash of a single element as used by ContentHash, or 0 if either Key or Info can't be hashed. The two hashes are mixed together so that
+//swapping the key and info between elements changes the result.
+template<typename Key, typename Info>
+size_t Ring<Key,Info>::HashOf(const Key& ID, const Info& Data){
+    if constexpr(IsHashable<Key>::value && IsHashable<Info>::value){
+        unsigned long long mixed = std::hash<Key>()(ID) * 0x9E3779B97F4A7C15ULL + std::hash<Info>()(Data);
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<size_t>(mixed ^ (mixed >> 31));
+    }
+    else{
+        (void)ID;
+        (void)Data;
+        return 0;
+    }
+}
+
+
 //This function removes all the elements from the Ring, keeping only the sentinel.
 template<typename Key, typename Info>
 void Ring<Key,Info>::Clear(){
-    while(!this->IsEmpty()) this->PopFront();;
+    if(this->IsEmpty()) return;
+    Node* temp = start->next;
+    while(temp != start){
+        Node* following = temp->next;
+        DestroyNode(temp,Arena);
+        temp = following;
+    }
+    start->next = start;
+    start->prev = start;
+    Size = 0;
+    this->Notify([](Observer* watcher){ watcher->Cleared(); });
 }
 
 
@@ -359,9 +1245,9 @@ template<typename Key, typename Info>
 void Ring<Key,Info>::Print() const{
 
     std::cout << "start<=>";
-    for(ConstIterator temp(start->next); temp != start ;++temp){
-    std::cout << '(' << *temp << ','<< &temp << ')' << "<=>";
-    }
+    this->Scan([](const Key& ID, const Info& Data){
+    std::cout << '(' << Data << ','<< ID << ')' << "<=>";
+    });
     std::cout << "start" << std::endl;
 
 }
@@ -393,64 +1279,125 @@ Ring<Key,Info>& Ring<Key,Info>::operator=(const Ring& other){
 }
 
 
-//This operator returns true if two Rings are equal, and false otherwise.
+//This operator returns true if two Rings are equal, and false otherwise. Rings of different sizes are rejected without going through their elements.
 template<typename Key, typename Info>
-bool Ring<Key,Info>::operator==(const Ring& other){
+bool Ring<Key,Info>::operator==(const Ring& other) const{
+    if(this == &other) return true;
     if(Size != other.Size) return false;
-    ConstIterator temp1 = this->GetFirst();
-    ConstIterator temp2 = other.GetFirst();
-
-    while(temp1 != start){
-        if(&temp1 != &temp2 || *temp1 != *temp2) return false;
-        ++temp1;
-        ++temp2;
-    }
-
-    return true;
+    const Node* temp2 = other.start->next;
+
+    return Walk(start->next,start,[&temp2](Node* temp1){
+        Prefetch(temp2->next);
+        bool differ = !(temp1->label == temp2->label) || !(temp1->value == temp2->value);
+        temp2 = temp2->next;
+        return differ;
+    }) == nullptr;
 }
 
 
 //This operator returns true if two Rings are unequal, and false otherwise.
 template<typename Key, typename Info>
-bool Ring<Key,Info>::operator!=(const Ring& other){
+bool Ring<Key,Info>::operator!=(const Ring& other) const{
     return !(*this == other);
 }
 
 
-//This function adds to a new Ring the elements of the passed Ring which pass a given condition. The new Ring is then returned at the end.
-template<typename Key, typename Info>
-Ring<Key, Info> Filter(const Ring<Key, Info>& source, bool(pred)(const Key&)){
-    Ring<Key,Info> NewRing;
-    typename Ring<Key,Info>::ConstIterator temp = source.GetFirst();
-    for(unsigned i=0; i<source.Length() ;i++){
-        if(pred(&temp)) NewRing.PushBack(&temp,*temp);
-        ++temp;
+//This function evaluates a condition on an element. The condition can be any callable taking either the key, or the key and the info of the element, and the right form is
+//picked at compile time, so a lambda passed as the condition is called directly and can be inlined into the loop calling it.
+template<typename Key, typename Info, typename Pred>
+bool TestElement(Pred& pred, const Key& ID, const Info& Data){
+    static_assert(std::is_invocable_r<bool,Pred&,const Key&,const Info&>::value || std::is_invocable_r<bool,Pred&,const Key&>::value,
+                  "The condition must be callable as bool(const Key&) or bool(const Key&, const Info&).");
+    if constexpr(std::is_invocable_r<bool,Pred&,const Key&,const Info&>::value) return pred(ID,Data);
+    else{
+        (void)Data;
+        return pred(ID);
     }
+}
+
+
+//This function adds to a new Ring the elements of the passed Ring which pass a given condition. The new Ring is then returned at the end. The condition can see either the key,
+//or the key and the info of each element (see TestElement), and may be a lambda holding state.
+template<typename Key, typename Info, typename Pred>
+Ring<Key, Info> Filter(const Ring<Key, Info>& source, Pred pred){
+    Ring<Key,Info> NewRing;
+    source.Scan([&NewRing,&pred](const Key& ID, const Info& Data){
+        if(TestElement(pred,ID,Data)) NewRing.PushBack(ID,Data);
+    });
 
     return NewRing;
 }
 
 
 //This function removes repeated instances of any key by reducing all the elements with the same key to a single element with that key and info equivalent to the aggregate of all their infos.
-//The process for aggregation is given by the user. These new reduced elements are then added to a new Ring. If an element is already unique, it's simply copied to the new Ring. The new
-//Ring is returned at the end.
-template<typename Key, typename Info>
-Ring<Key, Info> Unique(const Ring<Key, Info>& source, Info(aggregate)(const Key&, const Info&, const Info&)){
+//The process for aggregation is given by the user as any callable taking the key, the aggregate so far and the next info. These new reduced elements are then added to a new Ring. If an
+//element is already unique, it's simply copied to the new Ring. The new Ring is returned at the end.
+template<typename Key, typename Info, typename Aggregate>
+Ring<Key, Info> Unique(const Ring<Key, Info>& source, Aggregate aggregate){
+    static_assert(std::is_invocable_r<Info,Aggregate&,const Key&,const Info&,const Info&>::value,
+                  "The aggregate must be callable as Info(const Key&, const Info&, const Info&).");
     Ring<Key,Info> NewRing;
-    typename Ring<Key,Info>::ConstIterator temp = source.GetFirst();
-    typename Ring<Key,Info>::Iterator it = NewRing.GetFirst();
 
-    for(unsigned i=0; i<source.Length(); i++){
-        it = NewRing.LookFor(&temp);
-        if(!it.pointer) NewRing.PushBack(&temp,*temp);
-        else it.pointer->value = aggregate(&temp,it.pointer->value,*temp);
-        ++temp;
-    }
+    source.Scan([&NewRing,&aggregate](const Key& ID, const Info& Data){
+        typename Ring<Key,Info>::Iterator it = NewRing.LookFor(ID);
+        if(!it.pointer) NewRing.PushBack(ID,Data);
+        else NewRing.Update(it,aggregate(ID,it.pointer->value,Data));
+    });
+
+    return NewRing;
+}
+
+
+//This function adds to a new Ring an element for every element of the passed Ring, with the same key and the info returned by transform for that element. The transform is any
+//callable taking the key and the info of an element, and the info type of the new Ring is the type it returns. The new Ring is returned at the end.
+template<typename Key, typename Info, typename Transform>
+auto Map(const Ring<Key, Info>& source, Transform transform){
+    static_assert(std::is_invocable<Transform&,const Key&,const Info&>::value, "The transform must be callable with (const Key&, const Info&).");
+    typedef typename std::decay<typename std::invoke_result<Transform&,const Key&,const Info&>::type>::type Result;
+    Ring<Key,Result> NewRing;
+    source.Scan([&NewRing,&transform](const Key& ID, const Info& Data){
+        NewRing.PushBack(ID,transform(ID,Data));
+    });
 
     return NewRing;
 }
 
 
+//This function combines all the elements of the passed Ring into a single value. Starting from init, combine is called in order with the value so far and the key and info of each
+//element, and its result becomes the new value. The final value is returned at the end.
+template<typename Key, typename Info, typename T, typename Combine>
+T Reduce(const Ring<Key, Info>& source, T init, Combine combine){
+    static_assert(std::is_invocable_r<T,Combine&,const T&,const Key&,const Info&>::value, "The combine must be callable as T(const T&, const Key&, const Info&).");
+    source.Scan([&init,&combine](const Key& ID, const Info& Data){
+        init = combine(static_cast<const T&>(init),ID,Data);
+    });
+
+    return init;
+}
+
+
+//This function calls visit in order with the key and info of every element of the passed Ring.
+template<typename Key, typename Info, typename Visit>
+void ForEach(const Ring<Key, Info>& source, Visit visit){
+    static_assert(std::is_invocable<Visit&,const Key&,const Info&>::value, "The visit must be callable with (const Key&, const Info&).");
+    source.Scan(visit);
+}
+
+
+//This function splits the passed Ring into two new Rings, the first holding the elements which pass a given condition and the second holding the rest, both in their original
+//order. The condition is used in the same way as in Filter. The pair of new Rings is returned at the end.
+template<typename Key, typename Info, typename Pred>
+std::pair<Ring<Key, Info>, Ring<Key, Info>> Partition(const Ring<Key, Info>& source, Pred pred){
+    std::pair<Ring<Key,Info>,Ring<Key,Info>> NewRings;
+    source.Scan([&NewRings,&pred](const Key& ID, const Info& Data){
+        if(TestElement(pred,ID,Data)) NewRings.first.PushBack(ID,Data);
+        else NewRings.second.PushBack(ID,Data);
+    });
+
+    return NewRings;
+}
+
+
 //This function iterates through the first Ring, and with each step it searches for an element with an equivalent key in the second Ring. If such element is found, the info from
 //both elements is added together and then an element with the equivalent key and the sum of infos is added to a new Ring. If no such element is found, the element from the first
 //Ring is simply copied to the new Ring. Both lists are reduced to their unique form before this process begins by Using the function Unique. The new Ring is returned at the end.
@@ -498,6 +1445,105 @@ Ring<Key, Info> Shuffle(const Ring<Key, Info>& first, unsigned int fcnt,const Ri
 }
 
 
+//This class represents a window over the last Width elements read from a Ring by a cursor. Every call to Advance adds the element under the cursor to the window, drops the
+//oldest element once the window is full, and moves the cursor cyclically to the next element. The sum, minimum and maximum of the infos in the window are kept up to date in
+//O(1) amortized per step, so Info must support +, - and <. The window holds copies of the infos, so it's not affected by later changes to the Ring, but the cursor is.
+template<typename Key, typename Info>
+class SlidingWindow{
+
+private:
+    typename Ring<Key,Info>::Cursor Position;
+    unsigned int Width;
+    unsigned long long Count = 0;
+    Info Total = Info();
+    std::deque<Info> Contents;
+    std::deque<std::pair<unsigned long long,Info>> Lows;
+    std::deque<std::pair<unsigned long long,Info>> Highs;
+
+public:
+
+    //Constructor
+    SlidingWindow(const Ring<Key,Info>& source, unsigned int width) : Position(source.GetCursor()), Width(width){ assert(width > 0); }
+
+
+    //Constructor
+    SlidingWindow(const typename Ring<Key,Info>::Cursor& from, unsigned int width) : Position(from), Width(width){ assert(width > 0); }
+
+
+    const Info& Advance();
+
+
+
+    //This function returns the sum of the infos in the window.
+    const Info& Sum() const{ return Total; }
+
+
+    //This function returns the smallest info in the window. The window must not be empty.
+    const Info& Min() const{
+        assert(!Lows.empty());
+        return Lows.front().second;
+    }
+
+
+    //This function returns the largest info in the window. The window must not be empty.
+    const Info& Max() const{
+        assert(!Highs.empty());
+        return Highs.front().second;
+    }
+
+
+    //This function returns the number of elements currently in the window.
+    unsigned int Length() const{ return Contents.size(); }
+
+
+    //This function returns true if the window holds Width many elements, and false otherwise.
+    bool IsFull() const{ return Contents.size() == Width; }
+
+
+    //This function returns the cursor pointing to the element which will be added to the window by the next call to Advance.
+    const typename Ring<Key,Info>::Cursor& GetCursor() const{ return Position; }
+
+};
+
+
+//This function adds the info of the element under the cursor to the window, removing the oldest info if the window was full, and moves the cursor to the next element.
+//It returns the info that was added. The Ring must not be empty.
+template<typename Key, typename Info>
+const Info& SlidingWindow<Key,Info>::Advance(){
+    assert(!Position.IsSentinel());
+    const Info& Data = *Position;
+
+    if(Contents.size() == Width){
+        Total = Total - Contents.front();
+        Contents.pop_front();
+        if(Lows.front().first + Width == Count) Lows.pop_front();
+        if(Highs.front().first + Width == Count) Highs.pop_front();
+    }
+
+    Contents.push_back(Data);
+    Total = Total + Data;
+    while(!Lows.empty() && Data < Lows.back().second) Lows.pop_back();
+    Lows.emplace_back(Count,Data);
+    while(!Highs.empty() && Highs.back().second < Data) Highs.pop_back();
+    Highs.emplace_back(Count,Data);
+
+    ++Count;
+    ++Position;
+    return Contents.back();
+}
+
+
+//This specialization allows Rings to be used as keys of unordered containers. It uses ContentHash, so it takes O(n) and rings which are equal always have the same hash.
+namespace std{
+    template<typename Key, typename Info>
+    struct hash<Ring<Key,Info>>{
+        size_t operator()(const Ring<Key,Info>& src) const{
+            static_assert(IsHashable<Key>::value && IsHashable<Info>::value, "Key and Info must be hashable with std::hash to hash a Ring.");
+            return src.ContentHash();
+        }
+    };
+}
+
 
 
 #endif // RING
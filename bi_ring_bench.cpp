@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bi_ring.h"
+#include "ring_channel.h"
+
+
+//This function runs a given task reps many times and returns the average time it took in milliseconds.
+template<typename Task>
+double TimeIt(unsigned int reps, Task task){
+    auto begin = std::chrono::steady_clock::now();
+    for(unsigned i=0; i<reps ;i++) task();
+    std::chrono::duration<double,std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / reps;
+}
+
+
+//This function prints a single line of the results.
+void Report(const std::string& name, double baseline, double measured){
+    std::cout << name << ": " << baseline << " ms -> " << measured << " ms (x" << baseline / measured << ")" << std::endl;
+}
+
+
+//This function fills the Ring with n elements and then moves them to the front in a random order, so that the order of the Ring no longer follows the order
+//the nodes were allocated in. This is what a long-lived Ring looks like in memory, and it stops the hardware prefetcher from hiding the cost of pointer chasing.
+template<typename Key, typename Info>
+void FillScattered(Ring<Key,Info>& src, unsigned int n){
+    std::vector<typename Ring<Key,Info>::Iterator> Nodes;
+    Nodes.reserve(n);
+    for(unsigned i=0; i<n ;i++) Nodes.push_back(src.PushBack(Key(i),Info(i)));
+    std::shuffle(Nodes.begin(),Nodes.end(),std::mt19937(42));
+    for(auto& item : Nodes) src.Touch(item);
+}
+
+
+//This function searches for a key the same way LookFor did before the traversal kernel: a single cursor chasing pointers with no prefetching.
+template<typename Key, typename Info>
+typename Ring<Key,Info>::Iterator NaiveLookFor(const Ring<Key,Info>& src, const Key& item){
+    typename Ring<Key,Info>::Iterator temp = src.GetFirst();
+    for(unsigned i=0; i<src.Length() ;i++){
+        if(temp.pointer->label == item) return temp;
+        ++temp;
+    }
+    return nullptr;
+}
+
+
+//These functions are the conditions and aggregates used to time the function pointer versions of Filter, Unique and Reduce. They are called through pointers which
+//are only known at run time, the same way Filter and Unique called their conditions before they were templated on the callable.
+bool IsEven(const long long& x){ return x % 2 == 0; }
+long long Sum(const long long&, const long long& arg1, const long long& arg2){ return arg1 + arg2; }
+long long Accumulate(const long long& acc, const long long&, const long long& Data){ return acc + Data; }
+bool (*volatile EvenPointer)(const long long&) = IsEven;
+long long (*volatile SumPointer)(const long long&, const long long&, const long long&) = Sum;
+long long (*volatile AccumulatePointer)(const long long&, const long long&, const long long&) = Accumulate;
+
+
+//This function fills the Ring with n elements and then churns it the way a long-lived Ring is churned: half of the elements are erased in a random order, and half as many
+//new ones are inserted before random survivors, taking freed nodes in whatever order the allocator hands them back.
+void FillChurned(Ring<long long,std::string>& src, unsigned int n){
+    std::vector<Ring<long long,std::string>::Iterator> Nodes;
+    Nodes.reserve(n);
+    for(unsigned i=0; i<n ;i++) Nodes.push_back(src.PushBack(i,std::to_string(i)));
+    std::mt19937 Generator(7);
+    std::shuffle(Nodes.begin(),Nodes.end(),Generator);
+    for(unsigned i=0; i<n / 2 ;i++) src.Erase(Nodes[i]);
+    std::shuffle(Nodes.begin() + n / 2,Nodes.end(),Generator);
+    for(unsigned i=n / 2; i<n / 4 * 3 ;i++) src.Insert(Nodes[i],n + i,std::to_string(n + i));
+}
+
+
+//This function times a scan over a churned Ring before and after Compact, and prints how much memory it occupies before and after.
+void ReportCompact(const std::string& name, Ring<long long,std::string>& src, unsigned int reps){
+    volatile size_t Sink = 0;
+    auto ScanAll = [&src,&Sink](){
+        size_t Total = 0;
+        src.Scan([&Total](const long long& ID, const std::string& Data){ Total += ID + Data.size(); });
+        Sink = Total;
+    };
+    RingMemory Before = src.MemoryUsage();
+    double Fragmented = TimeIt(reps,ScanAll);
+    double Compacting = TimeIt(1,[&src](){ src.Compact(); });
+    double Compacted = TimeIt(reps,ScanAll);
+    RingMemory After = src.MemoryUsage();
+    Report(name + " scan",Fragmented,Compacted);
+    std::cout << "    Compact took " << Compacting << " ms; nodes " << Before.NodeBytes / 1024 << " KB, payload " << Before.PayloadBytes / 1024 << " KB, slack "
+              << Before.SlackBytes / 1024 << " KB -> slack " << After.SlackBytes / 1024 << " KB" << std::endl;
+    (void)Sink;
+}
+
+
+//This structure holds the results of one run of a pipeline.
+struct PipelineResult{
+    double milliseconds;
+    double averageLatency;
+    double maxLatency;
+};
+
+
+//This function returns the current time in microseconds, which records carry through a pipeline as their info to measure how long they took to get through.
+long long Now(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+//This function prints the throughput and latency of a pipeline.
+void ReportPipeline(const std::string& name, unsigned int records, const PipelineResult& result){
+    std::cout << name << ": " << records / result.milliseconds / 1000 << " M records/s, latency " << result.averageLatency << " us on average, "
+              << result.maxLatency << " us at most" << std::endl;
+}
+
+
+//This class is the stage to stage queue the pipelines used before RingChannel: a Ring behind a mutex, whose consumer polls IsEmpty and sleeps while it's empty, and
+//whose producer polls Length and sleeps while it's full.
+class PollingQueue{
+private:
+    Ring<long long,long long> Buffer;
+    std::mutex Lock;
+    unsigned int Capacity;
+public:
+    explicit PollingQueue(unsigned int capacity) : Capacity(capacity){}
+
+    void Push(long long ID, long long Data){
+        while(true){
+            {
+                std::lock_guard<std::mutex> locked(Lock);
+                if(Buffer.Length() < Capacity){
+                    Buffer.PushBack(ID,Data);
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void Pop(long long& ID, long long& Data){
+        while(true){
+            {
+                std::lock_guard<std::mutex> locked(Lock);
+                if(!Buffer.IsEmpty()){
+                    ID = Buffer.GetFirst().pointer->label;
+                    Data = Buffer.GetFirst().pointer->value;
+                    Buffer.PopFront();
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+};
+
+
+//This function runs a producer, a transforming stage and a consumer on three threads connected by polling queues. A negative key marks the end of the stream.
+PipelineResult PollingPipeline(unsigned int records, unsigned int capacity){
+    PollingQueue First(capacity);
+    PollingQueue Second(capacity);
+    PipelineResult Result{0,0,0};
+    auto begin = std::chrono::steady_clock::now();
+
+    std::thread Producer([&](){
+        for(unsigned i=0; i<records ;i++) First.Push(i,Now());
+        First.Push(-1,0);
+    });
+    std::thread Stage([&](){
+        long long ID = 0;
+        long long Data = 0;
+        while(ID >= 0){
+            First.Pop(ID,Data);
+            Second.Push(ID >= 0 ? ID * 3 + 1 : ID,Data);
+        }
+    });
+    std::thread Consumer([&](){
+        long long ID = 0;
+        long long Data = 0;
+        double Total = 0;
+        while(true){
+            Second.Pop(ID,Data);
+            if(ID < 0) break;
+            double Latency = Now() - Data;
+            Total += Latency;
+            Result.maxLatency = std::max(Result.maxLatency,Latency);
+        }
+        Result.averageLatency = Total / records;
+    });
+
+    Producer.join();
+    Stage.join();
+    Consumer.join();
+    Result.milliseconds = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return Result;
+}
+
+
+#if defined(__cpp_impl_coroutine)
+//These coroutines are the producer, transforming stage and consumer of the same pipeline connected by channels.
+ChannelTask ProduceRecords(RingChannel<long long,long long>& out, unsigned int records){
+    for(unsigned i=0; i<records ;i++) co_await out.Push(i,Now());
+    out.Close();
+}
+
+ChannelTask TransformRecords(RingChannel<long long,long long>& in, RingChannel<long long,long long>& out, unsigned int batch){
+    while(true){
+        std::vector<std::pair<long long,long long>> Taken = co_await in.PopBatch(batch);
+        if(Taken.empty()) break;
+        for(const auto& element : Taken) co_await out.Push(element.first * 3 + 1,element.second);
+    }
+    out.Close();
+}
+
+ChannelTask ConsumeRecords(RingChannel<long long,long long>& in, unsigned int batch, unsigned int records, PipelineResult& result){
+    double Total = 0;
+    while(true){
+        std::vector<std::pair<long long,long long>> Taken = co_await in.PopBatch(batch);
+        if(Taken.empty()) break;
+        long long Arrived = Now();
+        for(const auto& element : Taken){
+            double Latency = Arrived - element.second;
+            Total += Latency;
+            result.maxLatency = std::max(result.maxLatency,Latency);
+        }
+    }
+    result.averageLatency = Total / records;
+}
+
+
+//This function runs the channel pipeline on the given executor, which is run by run once every stage was spawned.
+template<typename Run>
+PipelineResult ChannelPipeline(ChannelExecutor& executor, Run run, unsigned int records, unsigned int capacity, unsigned int batch){
+    RingChannel<long long,long long> First(capacity);
+    RingChannel<long long,long long> Second(capacity);
+    PipelineResult Result{0,0,0};
+    auto begin = std::chrono::steady_clock::now();
+    executor.Spawn(ConsumeRecords(Second,batch,records,Result));
+    executor.Spawn(TransformRecords(First,Second,batch));
+    executor.Spawn(ProduceRecords(First,records));
+    run();
+    Result.milliseconds = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return Result;
+}
+#endif
+
+
+int main(){
+    //The Ring is made large enough (about 256MB of nodes) to not fit in the last level cache of any current machine.
+    const unsigned int Elements = 8 * 1024 * 1024;
+    const unsigned int Reps = 5;
+
+    std::cout << "-Scans over " << Elements << " scattered nodes-\n" << std::endl;
+
+    Ring<long long,long long> Scattered;
+    FillScattered(Scattered,Elements);
+    Ring<long long,long long> Copy(Scattered);
+
+    volatile bool Sink = false;
+    double Naive = TimeIt(Reps,[&](){ Sink = NaiveLookFor(Scattered,-1LL).pointer != nullptr; });
+    double Kernel = TimeIt(Reps,[&](){ Sink = Scattered.LookFor(-1LL).pointer != nullptr; });
+    Report("LookFor (missing key)",Naive,Kernel);
+
+    Naive = TimeIt(Reps,[&](){
+        long long Total = 0;
+        Ring<long long,long long>::Iterator temp = Scattered.GetFirst();
+        for(unsigned i=0; i<Scattered.Length() ;i++,++temp) Total += temp.pointer->value;
+        Sink = Total == 0;
+    });
+    Kernel = TimeIt(Reps,[&](){
+        long long Total = 0;
+        Scattered.Scan([&Total](const long long&, const long long& Data){ Total += Data; });
+        Sink = Total == 0;
+    });
+    Report("Scan (sum of infos)",Naive,Kernel);
+
+    Naive = TimeIt(Reps,[&](){
+        Ring<long long,long long>::Iterator temp1 = Scattered.GetFirst();
+        Ring<long long,long long>::Iterator temp2 = Copy.GetFirst();
+        bool Equal = true;
+        for(unsigned i=0; i<Scattered.Length() && Equal ;i++){
+            Equal = temp1.pointer->label == temp2.pointer->label && temp1.pointer->value == temp2.pointer->value;
+            ++temp1;
+            ++temp2;
+        }
+        Sink = Equal;
+    });
+    Kernel = TimeIt(Reps,[&](){ Sink = Scattered == Copy; });
+    Report("operator== (equal rings)",Naive,Kernel);
+
+    std::cout << "\n-Function pointers against lambdas-\n" << std::endl;
+
+    const unsigned int Small = 1024 * 1024;
+    Ring<long long,long long> Ordered;
+    for(unsigned i=0; i<Small ;i++) Ordered.PushBack(i,i);
+
+    bool (*Even)(const long long&) = EvenPointer;
+    double Pointer = TimeIt(Reps,[&](){ Sink = Filter(Ordered,Even).IsEmpty(); });
+    double Lambda = TimeIt(Reps,[&](){ Sink = Filter(Ordered,[](const long long& x){ return x % 2 == 0; }).IsEmpty(); });
+    Report("Filter",Pointer,Lambda);
+
+    long long (*Combine)(const long long&, const long long&, const long long&) = AccumulatePointer;
+    Pointer = TimeIt(Reps,[&](){ Sink = Reduce(Ordered,0LL,Combine) == 0; });
+    Lambda = TimeIt(Reps,[&](){ Sink = Reduce(Ordered,0LL,[](const long long& acc, const long long&, const long long& Data){ return acc + Data; }) == 0; });
+    Report("Reduce",Pointer,Lambda);
+
+    Ring<long long,long long> Repeated;
+    for(unsigned i=0; i<4096 ;i++) Repeated.PushBack(i % 64,i);
+    long long (*Aggregate)(const long long&, const long long&, const long long&) = SumPointer;
+    Pointer = TimeIt(Reps,[&](){ Sink = Unique(Repeated,Aggregate).IsEmpty(); });
+    Lambda = TimeIt(Reps,[&](){ Sink = Unique(Repeated,[](const long long&, const long long& arg1, const long long& arg2){ return arg1 + arg2; }).IsEmpty(); });
+    Report("Unique",Pointer,Lambda);
+
+    std::cout << "\n-Scans over a churned Ring before and after Compact-\n" << std::endl;
+
+    {
+        const unsigned int Churned = 4 * 1024 * 1024;
+        Ring<long long,std::string> Heap;
+        FillChurned(Heap,Churned);
+        ReportCompact("Heap",Heap,Reps);
+    }
+    {
+        const unsigned int Churned = 4 * 1024 * 1024;
+        NodeArena Arena;
+        Ring<long long,std::string> Arenaed(&Arena);
+        FillChurned(Arenaed,Churned);
+        size_t Reserved = Arena.ReservedBytes();
+        ReportCompact("NodeArena",Arenaed,Reps);
+        std::cout << "    arena reserved " << Reserved / 1024 << " KB -> " << Arena.ReservedBytes() / 1024 << " KB" << std::endl;
+    }
+
+    std::cout << "\n-Three stage pipeline-\n" << std::endl;
+
+    const unsigned int Records = 1000000;
+    const unsigned int Capacity = 1024;
+
+    PipelineResult Polling = PollingPipeline(Records,Capacity);
+    ReportPipeline("Mutex and polling, 3 threads",Records,Polling);
+
+#if defined(__cpp_impl_coroutine)
+    {
+        SingleThreadExecutor Loop;
+        PipelineResult Single = ChannelPipeline(Loop,[&Loop](){ Loop.Run(); },Records,Capacity,64);
+        ReportPipeline("RingChannel, single thread executor",Records,Single);
+    }
+    {
+        ThreadPoolExecutor Pool(3);
+        PipelineResult Pooled = ChannelPipeline(Pool,[&Pool](){ Pool.Join(); },Records,Capacity,64);
+        ReportPipeline("RingChannel, 3 thread pool",Records,Pooled);
+    }
+    {
+        ThreadPoolExecutor Pool(3);
+        PipelineResult Unbatched = ChannelPipeline(Pool,[&Pool](){ Pool.Join(); },Records,Capacity,1);
+        ReportPipeline("RingChannel, 3 thread pool, no batching",Records,Unbatched);
+    }
+#else
+    std::cout << "(RingChannel needs C++20 coroutines, build with -std=c++20 to compare it.)" << std::endl;
+#endif
+
+    (void)Sink;
+    return 0;
+}
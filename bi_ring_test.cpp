@@ -1,7 +1,18 @@
 #include <iostream>
 #include <string>
+#include <unordered_set>
 #include "bi_ring.h"
 #include "bi_ring_test.h"
+#include "lru_ring.h"
+#include "ring_views.h"
+#if defined(__unix__)
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ring_journal.h"
+#include "shm_ring.h"
+#endif
 
 int main(){
     Ring<int,std::string> TestRing;
@@ -333,6 +344,777 @@ int main(){
     TestRing2.Print();
 
 
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 6 ****************************  (Testing following functions: Touch, LruRing, ShardedLruRing.)
+    std::cout << "-Test Zone 6-\n" << std::endl;
+
+    TestRing.Clear();
+    for(unsigned i=1; i<=3 ;i++) TestRing.PushBack(i,std::to_string(i));
+    TestRing.Touch(TestRing.LookFor(3));
+    TestRing2.Clear();
+    TestRing2.PushBack(3,"3");
+    TestRing2.PushBack(1,"1");
+    TestRing2.PushBack(2,"2");
+    if(ImproperConnect(TestRing)) std::cout << "Improper connections after using Touch." << std::endl;
+    if(TestRing != TestRing2) std::cout << "Result of using Touch is not as expected." << std::endl;
+    TestRing.Touch(TestRing.GetFirst());
+    if(TestRing != TestRing2) std::cout << "List changed after using Touch on the first element." << std::endl;
+    it = nullptr;
+    TestEqual(it,TestRing.Touch(it),"Touch returns iterator when passed nullptr.");
+    TestRing.Print();
+
+    Ring<int,std::string> Evicted;
+    LruRing<int,std::string> Cache(3,Eviction::LRU,[&Evicted](const int& x, const std::string& y){ Evicted.PushBack(x,y); });
+    Cache.Put(1,"A");
+    Cache.Put(2,"B");
+    Cache.Put(3,"C");
+    Cache.Get(1);
+    Cache.Put(4,"D");
+    TestRing2.Clear();
+    TestRing2.PushBack(4,"D");
+    TestRing2.PushBack(1,"A");
+    TestRing2.PushBack(3,"C");
+    if(ImproperConnect(Cache.Contents())) std::cout << "Improper connections after eviction from LruRing." << std::endl;
+    if(Cache.Contents() != TestRing2) std::cout << "LruRing does not evict the least recently used element." << std::endl;
+    if(Evicted.Length() != 1 || Evicted.GetFirst().pointer->label != 2) std::cout << "Eviction callback not called with the evicted element." << std::endl;
+    it = nullptr;
+    TestEqual(it,Cache.Get(2),"LruRing returns iterator to evicted element.");
+    Cache.Put(3,"E");
+    TestEqual(Cache.GetFirst().pointer->value,std::string("E"),"Put on existing key does not update and move the element to the front.");
+    TestEqual(Cache.Length(),3u,"Put on existing key changes the size of LruRing.");
+    Cache.SetCapacity(1);
+    TestEqual(Cache.Length(),1u,"LruRing is not shrunk after using SetCapacity.");
+    TestEqual(Evicted.Length(),3u,"Eviction callback not called when shrinking LruRing.");
+    if(!Cache.Erase(3) || Cache.Contains(3) || !Cache.IsEmpty()) std::cout << "Erase does not remove element from LruRing." << std::endl;
+    Cache.Print();
+
+    LruRing<int,std::string> Queue(2,Eviction::FIFO);
+    Queue.Put(1,"A");
+    Queue.Put(2,"B");
+    Queue.Get(1);
+    Queue.Put(3,"C");
+    if(Queue.Contains(1) || !Queue.Contains(2)) std::cout << "FIFO LruRing does not evict the oldest element." << std::endl;
+    Queue.Print();
+
+    ShardedLruRing<int,std::string> Shared(64,4);
+    for(int i=0; i<32 ;i++) Shared.Put(i,std::to_string(i));
+    std::string Found;
+    if(!Shared.Get(7,Found) || Found != "7") std::cout << "ShardedLruRing does not return the info of a present key." << std::endl;
+    if(Shared.Get(99,Found)) std::cout << "ShardedLruRing returns info of a non-existent key." << std::endl;
+    if(!Shared.Erase(7) || Shared.Get(7,Found)) std::cout << "Erase does not remove element from ShardedLruRing." << std::endl;
+    TestEqual(Shared.Length(),31u,"Size of ShardedLruRing is not correct.");
+    ShardedLruRing<int,std::string> Uneven(100,16);
+    for(int i=0; i<1000 ;i++) Uneven.Put(i,std::to_string(i));
+    TestEqual(Uneven.Length(),100u,"ShardedLruRing does not hold exactly its capacity when it isn't a multiple of the number of shards.");
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 7 ****************************  (Testing following functions: ContentHash, Update, std::hash.)
+    std::cout << "-Test Zone 7-\n" << std::endl;
+
+    TestRing.Clear();
+    TestRing2.Clear();
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash of empty lists is not equal.");
+    for(unsigned i=1; i<=5 ;i++) TestRing.PushBack(i,std::to_string(i));
+    for(unsigned i=5; i>=1 ;i--) TestRing2.PushFront(i,std::to_string(i));
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash of equal lists built in different ways is not equal.");
+    TestRing.Print();
+    TestRing2.Print();
+
+    TestRing2.Insert(TestRing2.LookFor(3),9,"9");
+    TestDifference(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash not updated after using Insert.");
+    TestRing2.Erase(TestRing2.LookFor(9));
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash not restored after using Erase.");
+    TestRing2.PopFront();
+    TestRing2.PopBack();
+    TestRing2.PushFront(1,"1");
+    TestRing2.PushBack(5,"5");
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash not restored after using PopFront and PopBack.");
+
+    TestRing2.Update(TestRing2.LookFor(2),"two");
+    if(TestRing == TestRing2) std::cout << "Operator== returns true after using Update on one of two equal lists." << std::endl;
+    TestRing2.Update(TestRing2.LookFor(2),"2");
+    if(TestRing != TestRing2) std::cout << "Operator== returns false after using Update to restore an element." << std::endl;
+    it = nullptr;
+    TestEqual(it,TestRing2.Update(it,"-"),"Update returns iterator when passed nullptr.");
+
+    TestRing2.LookFor(4).pointer->value = "four";
+    if(TestRing == TestRing2) std::cout << "Operator== returns true for unequal lists after writing to one of them through an iterator." << std::endl;
+    TestDifference(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash does not change after writing to an element through an iterator.");
+    TestRing2.LookFor(4).pointer->value = "4";
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash not restored after writing back to an element through an iterator.");
+    TestRing.Update(TestRing.LookFor(3),"three");
+    TestRing2.LookFor(3).pointer->value = "three";
+    if(TestRing != TestRing2) std::cout << "Operator== returns false for equal lists after writing to one of them through an iterator." << std::endl;
+    TestEqual(TestRing.ContentHash(),TestRing2.ContentHash(),"Content hash of equal lists differs after writing to one of them through an iterator.");
+    if(std::unordered_set<Ring<int,std::string>>{TestRing}.count(TestRing2) != 1) std::cout << "Equal lists are not found in an unordered_set after writing to one of them through an iterator." << std::endl;
+    TestRing.Update(TestRing.LookFor(3),"3");
+    TestRing2.LookFor(3).pointer->value = "3";
+    TestRing2.Print();
+
+    std::unordered_set<Ring<int,std::string>> Seen;
+    Seen.insert(TestRing);
+    if(Seen.count(TestRing2) != 1) std::cout << "Equal lists are not found in an unordered_set." << std::endl;
+    TestRing2.PopBack();
+    if(Seen.count(TestRing2) != 0) std::cout << "Unequal lists are found in an unordered_set." << std::endl;
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 8 ****************************  (Testing following functions: Rotate, RotateTo, Cursor, SlidingWindow.)
+    std::cout << "-Test Zone 8-\n" << std::endl;
+
+    TestRing.Clear();
+    TestRing2.Clear();
+    for(unsigned i=1; i<=5 ;i++) TestRing.PushBack(i,std::to_string(i));
+    for(unsigned i=1; i<=5 ;i++) TestRing2.PushBack(i,std::to_string(i));
+    TestRing.Rotate(2);
+    for(unsigned i=0; i<2 ;i++){
+        TestRing2.PushBack(TestRing2.GetFirst().pointer->label,TestRing2.GetFirst().pointer->value);
+        TestRing2.PopFront();
+    }
+    if(ImproperConnect(TestRing)) std::cout << "Improper connections after using Rotate." << std::endl;
+    if(TestRing != TestRing2) std::cout << "Result of using Rotate is not the same as using PopFront and PushBack." << std::endl;
+    TestRing.Print();
+
+    TestRing.Rotate(-7);
+    TestRing.Rotate(4);
+    TestRing.Rotate(3);
+    if(ImproperConnect(TestRing)) std::cout << "Improper connections after using Rotate with negative and large counts." << std::endl;
+    if(TestRing != TestRing2) std::cout << "Result of using Rotate with negative and large counts is not as expected." << std::endl;
+    TestRing.Print();
+
+    it = TestRing.RotateTo(TestRing.LookFor(5));
+    TestEqual(it,TestRing.GetFirst(),"RotateTo does not make the element passed the first element.");
+    TestEqual(TestRing.GetLast().pointer->label,4,"RotateTo does not keep the order of the elements.");
+    TestEqual(TestRing.Length(),5u,"Size of list is not correct after using RotateTo.");
+    if(ImproperConnect(TestRing)) std::cout << "Improper connections after using RotateTo." << std::endl;
+    it = nullptr;
+    TestEqual(it,TestRing.RotateTo(it),"RotateTo returns iterator when passed nullptr.");
+    TestRing.Print();
+
+    Ring<int,std::string>::Cursor Position = TestRing.GetCursor(TestRing.GetLast());
+    ++Position;
+    TestEqual(&Position,5,"Cursor does not skip the sentinel when moving forward.");
+    --Position;
+    TestEqual(&Position,4,"Cursor does not skip the sentinel when moving backward.");
+
+    Ring<int,int> Numbers;
+    int Values[] = {4,1,3,5,2};
+    for(int Value : Values) Numbers.PushBack(Value,Value);
+    SlidingWindow<int,int> Window(Numbers,3);
+    Window.Advance();
+    Window.Advance();
+    Window.Advance();
+    if(Window.Sum() != 8 || Window.Min() != 1 || Window.Max() != 4) std::cout << "SlidingWindow aggregates are not correct after filling the window." << std::endl;
+    Window.Advance();
+    if(Window.Sum() != 9 || Window.Min() != 1 || Window.Max() != 5) std::cout << "SlidingWindow aggregates are not correct after dropping the oldest element." << std::endl;
+    Window.Advance();
+    Window.Advance();
+    if(Window.Sum() != 11 || Window.Min() != 2 || Window.Max() != 5) std::cout << "SlidingWindow aggregates are not correct after wrapping around the Ring." << std::endl;
+    TestEqual(Window.Length(),3u,"SlidingWindow holds more elements than its width.");
+    TestEqual(&Window.GetCursor(),1,"SlidingWindow cursor does not wrap around the Ring.");
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 9 ****************************  (Testing following functions: NodeArena, Ring(NodeArena*), Rebalance, Compact.)
+    std::cout << "-Test Zone 9-\n" << std::endl;
+
+    {
+        NodeArena Local(0);
+        NodeArena Missing(4095,64 * 1024);
+        Ring<int,std::string> ArenaRing(&Local);
+        TestRing.Clear();
+        for(unsigned i=1; i<=100 ;i++){
+            ArenaRing.PushBack(i,std::to_string(i));
+            TestRing.PushBack(i,std::to_string(i));
+        }
+        ArenaRing.Erase(ArenaRing.LookFor(50));
+        TestRing.Erase(TestRing.LookFor(50));
+        ArenaRing.PushFront(0,"0");
+        TestRing.PushFront(0,"0");
+        if(ImproperConnect(ArenaRing)) std::cout << "Improper connections in list allocated from NodeArena." << std::endl;
+        if(ArenaRing != TestRing) std::cout << "List allocated from NodeArena is not equal to list allocated from the heap." << std::endl;
+        if(Local.UsedBytes() == 0 || Local.ReservedBytes() < Local.UsedBytes()) std::cout << "NodeArena does not account for the nodes allocated from it." << std::endl;
+
+        Ring<int,std::string> CopyRing(ArenaRing);
+        TestEqual(CopyRing.GetArena(),&Local,"Copy of list does not use the NodeArena of the source.");
+        if(CopyRing != ArenaRing) std::cout << "Copy of list allocated from NodeArena is not equal to the source." << std::endl;
+
+        TestRing.Rebalance(&Missing);
+        TestEqual(TestRing.GetArena(),&Missing,"List does not use the NodeArena passed to Rebalance.");
+        if(Missing.IsNumaBound()) std::cout << "NodeArena reports being bound to a non-existent NUMA node." << std::endl;
+        if(ImproperConnect(TestRing)) std::cout << "Improper connections after using Rebalance." << std::endl;
+        if(ArenaRing != TestRing) std::cout << "Result of using Rebalance is not as expected." << std::endl;
+        bool Ordered = true;
+        for(Ring<int,std::string>::Iterator temp = TestRing.GetFirst(); temp != TestRing.GetLast() ;++temp){
+            if(temp.pointer->next < temp.pointer) Ordered = false;
+        }
+        if(!Ordered) std::cout << "Nodes are not placed in traversal order after using Rebalance." << std::endl;
+
+        ArenaRing.Compact();
+        if(ImproperConnect(ArenaRing) || ArenaRing != TestRing) std::cout << "Result of using Compact is not as expected." << std::endl;
+
+        TestRing.Rebalance(nullptr);
+        TestEqual(Missing.UsedBytes(),size_t(0),"Nodes are not returned to the NodeArena after using Rebalance to move them to the heap.");
+        if(ArenaRing != TestRing) std::cout << "Result of using Rebalance to move nodes to the heap is not as expected." << std::endl;
+
+        NodeArena Partial(-1,4096);
+        Ring<int,FragileInfo> Moving;
+        for(int i=0; i<50 ;i++) Moving.PushBack(i,FragileInfo(i));
+        FragileInfo::MovesLeft = 10;
+        bool Thrown = false;
+        try{
+            Moving.Rebalance(&Partial);
+        }
+        catch(const std::runtime_error&){
+            Thrown = true;
+        }
+        FragileInfo::MovesLeft = -1;
+        if(!Thrown || ImproperConnect(Moving) || Moving.Length() != 9 || Moving.GetLast().pointer->label != 8) std::cout << "Rebalance does not keep the elements moved before a node failed to build." << std::endl;
+        TestEqual(Moving.GetArena(),&Partial,"List does not use the NodeArena passed to Rebalance after a node failed to build.");
+        size_t MovingNodes = Moving.Length() + 1;
+        TestEqual(Partial.UsedBytes(),NodeArena::BlockSize(Moving.MemoryUsage().NodeBytes / MovingNodes) * MovingNodes,"NodeArena does not hold exactly the nodes moved by Rebalance before a node failed to build.");
+    }
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 10 ****************************  (Testing following functions: Scan, LookFor and LookThrough on repeated keys.)
+    std::cout << "-Test Zone 10-\n" << std::endl;
+
+    TestRing.Clear();
+    int Keys[] = {5,6,7,8,9,7,6,10,11,12,7};
+    for(int Value : Keys) TestRing.PushBack(Value,std::to_string(TestRing.Length()));
+    TestRing.Print();
+    TestEqual(TestRing.LookFor(6).pointer->value,std::string("1"),"LookFor does not return the first element with a key repeated across both halves.");
+    TestEqual(TestRing.LookFor(7).pointer->value,std::string("2"),"LookFor does not return the first element with a key repeated three times.");
+    TestEqual(TestRing.LookFor(10).pointer->value,std::string("7"),"LookFor does not return an element found only in the back half.");
+    TestEqual(TestRing.LookFor(12).pointer->value,std::string("9"),"LookFor does not return the element before the last one.");
+    it = nullptr;
+    TestEqual(it,TestRing.LookFor(13),"LookFor returns iterator to non-existent element.");
+    it = TestRing.LookFor(9);
+    TestEqual(TestRing.LookThrough(7,it,it).pointer->value,std::string("5"),"LookThrough does not go around the whole list when End is equal to Begin.");
+    TestEqual(TestRing.LookThrough(5,it,it).pointer->value,std::string("0"),"LookThrough does not wrap around past the sentinel.");
+
+    unsigned int Visited = 0;
+    int KeySum = 0;
+    TestRing.Scan([&Visited,&KeySum](const int& x, const std::string&){ ++Visited; KeySum += x; });
+    TestEqual(Visited,TestRing.Length(),"Scan does not visit every element exactly once.");
+    TestEqual(KeySum,88,"Scan does not pass the keys of the elements.");
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 11 ****************************  (Testing following functions: Filter and Unique with lambdas, Map, Reduce, ForEach, Partition.)
+    std::cout << "-Test Zone 11-\n" << std::endl;
+
+    TestRing.Clear();
+    for(unsigned i=1; i<=6 ;i++) TestRing.PushBack(i,std::to_string(i * 10));
+    TestRing.Print();
+
+    int Threshold = 3;
+    TestRing2 = Filter(TestRing,[Threshold](const int& x){ return x > Threshold; });
+    TestEqual(TestRing2.Length(),3u,"Filter with a stateful condition does not keep the right number of elements.");
+    TestRing2 = Filter(TestRing,[](const int& x, const std::string& y){ return x % 2 == 0 && y != "40"; });
+    if(ImproperConnect(TestRing2)) std::cout << "Improper connections after using Filter with a condition on key and info." << std::endl;
+    if(TestRing2.Length() != 2 || TestRing2.GetFirst().pointer->label != 2 || TestRing2.GetLast().pointer->label != 6) std::cout << "Result of using Filter with a condition on key and info is not as expected." << std::endl;
+    TestRing2.Print();
+
+    std::string Separator = "|";
+    TestRing2 = TestRing;
+    TestRing2 = TestRing2 + TestRing;
+    TestRing2 = Unique(TestRing2,[&Separator](const int&, const std::string& arg1, const std::string& arg2){ return arg1 + Separator + arg2; });
+    TestEqual(TestRing2.Length(),6u,"Size of list is not correct after using Unique with a stateful aggregate.");
+    TestEqual(TestRing2.GetFirst().pointer->value,std::string("10|10"),"Result of using Unique with a stateful aggregate is not as expected.");
+    TestRing2.Print();
+
+    Ring<int,size_t> Lengths = Map(TestRing,[](const int&, const std::string& y){ return y.size(); });
+    TestEqual(Lengths.Length(),TestRing.Length(),"Size of list is not correct after using Map.");
+    TestEqual(Lengths.GetFirst().pointer->value,size_t(2),"Result of using Map is not as expected.");
+    TestEqual(Lengths.GetFirst().pointer->label,1,"Map does not keep the keys of the elements.");
+    Lengths.Print();
+
+    TestEqual(Reduce(TestRing,0,[](const int& acc, const int& x, const std::string&){ return acc + x; }),21,"Result of using Reduce is not as expected.");
+    TestEqual(Reduce(TestRing,std::string(),[](const std::string& acc, const int&, const std::string& y){ return acc + y; }),std::string("102030405060"),"Reduce does not go through the elements in order.");
+
+    Visited = 0;
+    ForEach(TestRing,[&Visited](const int&, const std::string&){ ++Visited; });
+    TestEqual(Visited,TestRing.Length(),"ForEach does not visit every element exactly once.");
+
+    std::pair<Ring<int,std::string>,Ring<int,std::string>> Halves = Partition(TestRing,[](const int& x){ return x <= 2; });
+    if(ImproperConnect(Halves.first) || ImproperConnect(Halves.second)) std::cout << "Improper connections after using Partition." << std::endl;
+    TestEqual(Halves.first.Length(),2u,"Size of the first list is not correct after using Partition.");
+    TestEqual(Halves.second.Length(),4u,"Size of the second list is not correct after using Partition.");
+    TestRing2 = Halves.first;
+    if(TestRing2 + Halves.second != TestRing) std::cout << "Result of using Partition is not as expected." << std::endl;
+    Halves.first.Print();
+    Halves.second.Print();
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 12 ****************************  (Testing following functions: Observer, UniqueView, JoinView.)
+    std::cout << "-Test Zone 12-\n" << std::endl;
+
+    {
+        Ring<int,int> Source;
+        Ring<int,int> Other;
+        int Pairs[][2] = {{1,10},{2,20},{1,5},{3,7},{2,1}};
+        for(auto& Pair : Pairs) Source.PushBack(Pair[0],Pair[1]);
+        Other.PushBack(2,100);
+        Other.PushBack(4,400);
+        auto Add = [](const int&, const int& arg1, const int& arg2){ return arg1 + arg2; };
+        auto Subtract = [](const int&, const int& arg1, const int& arg2){ return arg1 - arg2; };
+        auto Larger = [](const int&, const int& arg1, const int& arg2){ return arg1 > arg2 ? arg1 : arg2; };
+
+        UniqueView<int,int> Sums(Source,Add,Subtract);
+        UniqueView<int,int> Maxima(Source,Larger);
+        JoinView<int,int> Joined(Source,Other);
+        if(!SameElements(Sums.GetResult(),Unique(Source,Add))) std::cout << "UniqueView does not start out equal to Unique of its source." << std::endl;
+        if(!SameElements(Joined.GetResult(),Join(Source,Other))) std::cout << "JoinView does not start out equal to Join of its sources." << std::endl;
+
+        Source.PushFront(3,3);
+        Source.Insert(Source.LookFor(2),5,50);
+        Source.PopBack();
+        Source.Erase(Source.LookFor(1));
+        Source.Update(Source.LookFor(3),30);
+        Other.PushBack(3,1000);
+        Other.PopFront();
+        if(!SameElements(Sums.GetResult(),Unique(Source,Add))) std::cout << "UniqueView with an inverse is not equal to Unique of its source after changes." << std::endl;
+        if(!SameElements(Maxima.GetResult(),Unique(Source,Larger))) std::cout << "UniqueView without an inverse is not equal to Unique of its source after changes." << std::endl;
+        if(!SameElements(Joined.GetResult(),Join(Source,Other))) std::cout << "JoinView is not equal to Join of its sources after changes." << std::endl;
+        if(ImproperConnect(Sums.GetResult()) || ImproperConnect(Joined.GetResult())) std::cout << "Improper connections in the result of a view after changes." << std::endl;
+        Sums.GetResult().Print();
+        Joined.GetResult().Print();
+
+        Source.Erase(Source.LookFor(5));
+        if(Sums.Find(5) != Sums.Find(99) || Joined.GetResult().LookFor(5).pointer != nullptr) std::cout << "Views keep a key after its last element was removed from the source." << std::endl;
+
+        Source.Clear();
+        if(!Sums.GetResult().IsEmpty() || !Maxima.GetResult().IsEmpty() || !Joined.GetResult().IsEmpty()) std::cout << "Views are not empty after their source was cleared." << std::endl;
+        Source.PushBack(4,4);
+        if(!SameElements(Joined.GetResult(),Join(Source,Other))) std::cout << "JoinView is not equal to Join of its sources after clearing and refilling." << std::endl;
+        Joined.GetResult().Print();
+
+        Source.PushBack(6,60);
+        Source.PushBack(7,70);
+        Source.LookFor(6).pointer->label = 8;
+        Source.Erase(Source.LookFor(8));
+        if(!SameElements(Sums.GetResult(),Unique(Source,Add)) || !SameElements(Joined.GetResult(),Join(Source,Other))) std::cout << "Views are not equal to their sources after removing an element whose key was written to through an iterator." << std::endl;
+        Source.LookFor(7).pointer->value = 7;
+        Sums.Resync();
+        Maxima.Resync();
+        Joined.Resync();
+        if(!SameElements(Sums.GetResult(),Unique(Source,Add)) || !SameElements(Maxima.GetResult(),Unique(Source,Larger)) || !SameElements(Joined.GetResult(),Join(Source,Other))){
+            std::cout << "Views are not equal to their sources after using Resync." << std::endl;
+        }
+
+        Ring<int,int>* Temporary = new Ring<int,int>;
+        Temporary->PushBack(1,1);
+        UniqueView<int,int> Orphan(*Temporary,Add);
+        delete Temporary;
+        if(Orphan.IsAttached() || Orphan.GetResult().Length() != 1) std::cout << "UniqueView does not keep its result after its source was destroyed." << std::endl;
+    }
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 13 ****************************  (Testing following functions: LookForMany, LookThroughMany.)
+    std::cout << "-Test Zone 13-\n" << std::endl;
+
+    {
+        Ring<int,int> Many;
+        for(int i=1; i<=200 ;i++) Many.PushBack(i % 50 + 1,i);
+        std::vector<int> FewKeys = {7,300,7,1};
+        std::vector<int> ManyKeys;
+        for(int i=0; i<40 ;i++) ManyKeys.push_back(i * 3 % 60);
+
+        if(!MatchesLookFor(Many,FewKeys,Many.LookForMany(FewKeys))) std::cout << "LookForMany does not match LookFor for a small batch." << std::endl;
+        if(!MatchesLookFor(Many,ManyKeys,Many.LookForMany(ManyKeys))) std::cout << "LookForMany does not match LookFor for a large batch." << std::endl;
+        if(!Many.LookForMany(std::vector<int>()).empty()) std::cout << "LookForMany does not return an empty batch for an empty batch of keys." << std::endl;
+
+        Ring<OrderedKey,int> Sortable;
+        for(int i=1; i<=100 ;i++) Sortable.PushBack(OrderedKey(i % 30 + 1),i);
+        std::vector<OrderedKey> SortableKeys;
+        for(int i=40; i>0 ;i--) SortableKeys.push_back(OrderedKey(i));
+        if(!MatchesLookFor(Sortable,SortableKeys,Sortable.LookForMany(SortableKeys))) std::cout << "LookForMany does not match LookFor for keys which can't be hashed." << std::endl;
+
+        Ring<int,int> Large;
+        for(int i=0; i<100000 ;i++) Large.PushBack(i % 70000,i);
+        std::vector<int> LargeKeys;
+        for(int i=0; i<500 ;i++) LargeKeys.push_back(i * 137 % 80000);
+        if(!MatchesLookFor(Large,LargeKeys,Large.LookForMany(LargeKeys,true))) std::cout << "LookForMany in parallel does not match LookFor." << std::endl;
+        std::vector<int> FrontKeys;
+        for(int i=0; i<100 ;i++) FrontKeys.push_back(i * 3);
+        if(!MatchesLookFor(Large,FrontKeys,Large.LookForMany(FrontKeys,true))) std::cout << "LookForMany in parallel does not match LookFor for keys near the beginning." << std::endl;
+
+        Ring<int,int>::Iterator Begin = Many.LookFor(40);
+        Ring<int,int>::Iterator End = Many.LookFor(5);
+        std::vector<Ring<int,int>::Iterator> Through = Many.LookThroughMany(ManyKeys,Begin,End);
+        bool Matches = true;
+        for(unsigned i=0; i<ManyKeys.size() ;i++) if(Through[i] != Many.LookThrough(ManyKeys[i],Begin,End)) Matches = false;
+        if(!Matches) std::cout << "LookThroughMany does not match LookThrough." << std::endl;
+        Through = Many.LookThroughMany(FewKeys,Begin,Begin);
+        Matches = true;
+        for(unsigned i=0; i<FewKeys.size() ;i++) if(Through[i] != Many.LookThrough(FewKeys[i],Begin,Begin)) Matches = false;
+        if(!Matches) std::cout << "LookThroughMany does not match LookThrough when End is equal to Begin." << std::endl;
+        Through = Many.LookThroughMany(FewKeys,nullptr,End);
+        if(Through.size() != FewKeys.size() || Through[0].pointer != nullptr) std::cout << "LookThroughMany returns iterators when Begin is nullptr." << std::endl;
+    }
+
+
+    std::cout << '\n' << std::endl;
+
+
+    //****************************** test zone 14 ****************************  (Testing following functions: SharedRing across two processes.)
+    std::cout << "-Test Zone 14-\n" << std::endl;
+
+#if defined(__unix__)
+    {
+        const std::string SegmentName = "/bi_ring_test_" + std::to_string(getpid());
+        const int Records = 10000;
+        SharedRing<int,double>* Channel = SharedRing<int,double>::Create(SegmentName,64);
+
+        int PairKey = 0;
+        double PairInfo = 0;
+        if(Channel->PopFront(PairKey,PairInfo)) std::cout << "PopFront returns an element from an empty SharedRing." << std::endl;
+        for(int i=0; i<64 ;i++) Channel->PushBack(i,i);
+        if(Channel->PushFront(-1,-1)) std::cout << "PushFront adds an element to a full SharedRing." << std::endl;
+        if(!Channel->PopBack(PairKey,PairInfo) || PairKey != 63) std::cout << "PopBack does not return the last element of a SharedRing." << std::endl;
+        Channel->PushFront(-1,-1);
+        if(!Channel->PopFront(PairKey,PairInfo) || PairKey != -1) std::cout << "PopFront does not return the first element of a SharedRing." << std::endl;
+        while(Channel->PopFront(PairKey,PairInfo));
+
+        pid_t Child = fork();
+        if(Child == 0){
+            SharedRing<int,double>* Producer = SharedRing<int,double>::Open(SegmentName);
+            for(int i=0; i<Records ;i++){
+                while(!Producer->PushBack(i,i * 0.5)) sched_yield();
+            }
+            delete Producer;
+            _exit(0);
+        }
+
+        bool InOrder = true;
+        for(int i=0; i<Records ;i++){
+            Channel->WaitPopFront(PairKey,PairInfo);
+            if(PairKey != i || PairInfo != i * 0.5) InOrder = false;
+        }
+        int ChildStatus = 0;
+        waitpid(Child,&ChildStatus,0);
+        if(!InOrder) std::cout << "Elements pushed by another process are not received in order through SharedRing." << std::endl;
+        if(!WIFEXITED(ChildStatus) || WEXITSTATUS(ChildStatus) != 0) std::cout << "Producer process using SharedRing did not exit cleanly." << std::endl;
+        if(!Channel->IsEmpty()) std::cout << "SharedRing is not empty after every element was popped." << std::endl;
+
+        bool Refused = false;
+        try{ delete SharedRing<int,double>::Create(SegmentName,8); }
+        catch(const std::runtime_error&){ Refused = true; }
+        if(!Refused) std::cout << "Create replaces a shared memory segment which is still in use." << std::endl;
+
+        if(Channel->WaitPopFront(PairKey,PairInfo,20)) std::cout << "WaitPopFront with a timeout returns an element from an empty SharedRing." << std::endl;
+        Channel->PushBack(1,1);
+        Channel->Close();
+        if(Channel->PushBack(2,2) || !Channel->IsClosed()) std::cout << "SharedRing accepts elements after being closed." << std::endl;
+        if(!Channel->WaitPopFront(PairKey,PairInfo) || PairKey != 1) std::cout << "Elements added before Close can't be popped from a SharedRing." << std::endl;
+        if(Channel->WaitPopFront(PairKey,PairInfo)) std::cout << "WaitPopFront returns an element from an empty closed SharedRing." << std::endl;
+        delete Channel;
+
+        SharedRing<int,double>* Abandoned = SharedRing<int,double>::Create(SegmentName,16);
+        pid_t Victim = fork();
+        if(Victim == 0){
+            SharedRing<int,double>* Worker = SharedRing<int,double>::Open(SegmentName);
+            while(true){
+                Worker->PushBack(1,1);
+                Worker->PopFront(PairKey,PairInfo);
+            }
+        }
+        usleep(50000);
+        kill(Victim,SIGKILL);
+        waitpid(Victim,nullptr,0);
+        while(Abandoned->PopFront(PairKey,PairInfo));
+        int Refilled = 0;
+        while(Abandoned->PushBack(Refilled,Refilled)) Refilled++;
+        if(Refilled != 16 || Abandoned->Length() != 16) std::cout << "SharedRing is not usable after a process died while using it." << std::endl;
+        delete Abandoned;
+    }
+#endif
+
+
+    //****************************** test zone 15 ****************************  (Testing following functions: RingJournal, Flush, Compact, Replay.)
+    std::cout << "-Test Zone 15-\n" << std::endl;
+
+#if defined(__unix__)
+    {
+        const std::string LogPath = "/tmp/bi_ring_test_" + std::to_string(getpid()) + ".journal";
+        Ring<int,std::string> Journaled;
+        Journaled.PushBack(1,"one");
+        Journaled.PushBack(2,"two");
+
+        JournalOptions Options;
+        Options.CompactBytes = 0;
+        RingJournal<int,std::string>* Journal = new RingJournal<int,std::string>(Journaled,LogPath,Options);
+        for(int i=3; i<=20 ;i++) Journaled.PushBack(i,std::to_string(i));
+        Journaled.PushFront(0,"zero");
+        Journaled.Insert(Journaled.LookFor(10),-10,"inserted");
+        Journaled.Erase(Journaled.LookFor(5));
+        Journaled.PopFront();
+        Journaled.PopBack();
+        Journaled.Update(Journaled.LookFor(7),"seven");
+        Journaled.Touch(Journaled.LookFor(15));
+        Journaled.Rotate(4);
+        if(!Journal->Flush()) std::cout << "Flush reports a failure to write the journal." << std::endl;
+
+        Ring<int,std::string> Recovered;
+        unsigned int Records = RingJournal<int,std::string>::Replay(LogPath,Recovered);
+        if(Records == 0 || Recovered != Journaled) std::cout << "Replay does not rebuild the journaled Ring." << std::endl;
+
+        Journal->Compact();
+        Journaled.PushBack(100,"after compaction");
+        Journal->Flush();
+        Ring<int,std::string> Compacted;
+        if(RingJournal<int,std::string>::Replay(LogPath,Compacted) != Journaled.Length() || Compacted != Journaled) std::cout << "Compact does not leave a single record for every element." << std::endl;
+
+        Journaled.Clear();
+        Journaled.PushBack(42,"last");
+        delete Journal;
+        Journaled.PushBack(43,"not journaled");
+
+        Ring<int,std::string> Closed;
+        RingJournal<int,std::string>::Replay(LogPath,Closed);
+        if(Closed.Length() != 1 || Closed.GetFirst().pointer->label != 42) std::cout << "Records are lost when the journal is destroyed." << std::endl;
+
+        FILE* Torn = fopen(LogPath.c_str(),"ab");
+        fwrite("\x20\x00\x00\x00\x02garbage",1,12,Torn);
+        fclose(Torn);
+        Ring<int,std::string> AfterCrash;
+        RingJournal<int,std::string>::Replay(LogPath,AfterCrash);
+        if(AfterCrash != Closed) std::cout << "Replay does not stop at a torn record." << std::endl;
+
+        Ring<int,std::string> Automatic;
+        Options.CompactBytes = 4096;
+        Options.CommitMicroseconds = 0;
+        {
+            RingJournal<int,std::string> Small(Automatic,LogPath,Options);
+            for(int i=0; i<2000 ;i++){
+                Automatic.PushBack(i,"element");
+                if(i % 3 == 0) Automatic.PopFront();
+            }
+            Small.Flush();
+            if(!Small.IsHealthy()) std::cout << "Journal reports a failure while compacting automatically." << std::endl;
+        }
+        Ring<int,std::string> AutomaticRecovered;
+        RingJournal<int,std::string>::Replay(LogPath,AutomaticRecovered);
+        if(AutomaticRecovered != Automatic) std::cout << "Replay does not rebuild a Ring whose journal was compacted automatically." << std::endl;
+
+        Ring<int,std::string> Growing;
+        for(int i=0; i<2000 ;i++) Growing.PushBack(i,"element");
+        Options.Sync = false;
+        {
+            RingJournal<int,std::string> Bounded(Growing,LogPath,Options);
+            for(int i=0; i<20000 ;i++) Growing.PushBack(i,"element");
+            Bounded.Flush();
+            if(Bounded.SnapshotCount() < 2 || Bounded.SnapshotCount() > 20000 * 24 / Options.CompactBytes + 2) std::cout << "Journal compacts more often than every CompactBytes of records." << std::endl;
+        }
+        Ring<int,std::string> GrowingRecovered;
+        RingJournal<int,std::string>::Replay(LogPath,GrowingRecovered);
+        if(GrowingRecovered != Growing) std::cout << "Replay does not rebuild a large Ring whose journal was compacted automatically." << std::endl;
+
+        Ring<int,std::string> Touched;
+        for(int i=0; i<100 ;i++) Touched.PushBack(i,"element");
+        {
+            RingJournal<int,std::string> Recent(Touched,LogPath,Options);
+            for(int i=0; i<20000 ;i++) Touched.Touch(Touched.GetLast());
+            Recent.Flush();
+            struct stat Status;
+            if(Recent.SnapshotCount() < 2 || stat(LogPath.c_str(),&Status) != 0 || static_cast<size_t>(Status.st_size) > 2 * Options.CompactBytes + 100 * 24) std::cout << "Journal does not compact a log grown only by Touch." << std::endl;
+        }
+        Ring<int,std::string> TouchedRecovered;
+        RingJournal<int,std::string>::Replay(LogPath,TouchedRecovered);
+        if(TouchedRecovered != Touched) std::cout << "Replay does not rebuild a Ring whose journal was compacted while using Touch." << std::endl;
+
+        Ring<int,std::string> Shuffled;
+        for(int i=0; i<500 ;i++) Shuffled.PushBack(i,"element");
+        {
+            RingJournal<int,std::string> Middle(Shuffled,LogPath,Options);
+            for(int i=0; i<5000 ;i++){
+                Ring<int,std::string>::Iterator temp = Shuffled.GetFirst();
+                for(int j=0; j<(i * 7) % 400 ;j++) ++temp;
+                switch(i % 5){
+                    case 0: Shuffled.Insert(temp,i,"inserted"); break;
+                    case 1: Shuffled.Erase(temp); break;
+                    case 2: Shuffled.Update(temp,"updated"); break;
+                    case 3: Shuffled.Touch(temp); break;
+                    case 4: Shuffled.RotateTo(temp); break;
+                }
+                if(i == 2500) Shuffled.Compact();
+            }
+            Middle.Flush();
+        }
+        Ring<int,std::string> ShuffledRecovered;
+        RingJournal<int,std::string>::Replay(LogPath,ShuffledRecovered);
+        if(ShuffledRecovered != Shuffled) std::cout << "Replay does not rebuild a Ring changed in the middle across compactions." << std::endl;
+        unlink(LogPath.c_str());
+    }
+#endif
+
+
+    //****************************** test zone 16 ****************************  (Testing following functions: RingChannel, SingleThreadExecutor, ThreadPoolExecutor.)
+    std::cout << "-Test Zone 16-\n" << std::endl;
+
+#if defined(__cpp_impl_coroutine)
+    {
+        SingleThreadExecutor Loop;
+        RingChannel<int,int> Bounded(4);
+        std::atomic<int> OneProducer(1);
+        std::vector<int> Received;
+        int Corrupted = 0;
+
+        Loop.Spawn(Produce(Bounded,1,10,OneProducer));
+        if(Loop.Run() != 1 || Bounded.Length() != 4) std::cout << "Push does not wait while the channel is full." << std::endl;
+        Loop.Spawn(Consume(Bounded,3,Received,Corrupted));
+        if(Loop.Run() != 0 || !Bounded.IsClosed()) std::cout << "Tasks do not finish after the channel is closed." << std::endl;
+        std::vector<int> Expected;
+        for(int i=1; i<=10 ;i++) Expected.push_back(i);
+        if(Received != Expected || Corrupted != 0) std::cout << "Elements do not pass through the channel in order." << std::endl;
+
+        RingChannel<int,int> Single(2);
+        std::optional<std::pair<int,int>> Popped;
+        bool Pushed = true;
+        Loop.Spawn([](RingChannel<int,int>& channel, std::optional<std::pair<int,int>>& popped) -> ChannelTask{ popped = co_await channel.Pop(); }(Single,Popped));
+        if(Loop.Run() != 1) std::cout << "Pop does not wait while the channel is empty." << std::endl;
+        Loop.Spawn([](RingChannel<int,int>& channel) -> ChannelTask{ co_await channel.Push(7,70); }(Single));
+        Loop.Run();
+        if(!Popped || Popped->first != 7 || Popped->second != 70) std::cout << "Pop does not return the element pushed to a waiting consumer." << std::endl;
+        Single.Close();
+        Loop.Spawn([](RingChannel<int,int>& channel, bool& pushed, std::optional<std::pair<int,int>>& popped) -> ChannelTask{
+            pushed = co_await channel.Push(8,80);
+            popped = co_await channel.Pop();
+        }(Single,Pushed,Popped));
+        if(Loop.Run() != 0 || Pushed || Popped) std::cout << "A closed channel accepts elements or returns them." << std::endl;
+
+        RingChannel<int,int> Shared(64);
+        std::atomic<int> Producers(3);
+        std::vector<int> First;
+        std::vector<int> Second;
+        int FirstCorrupted = 0;
+        int SecondCorrupted = 0;
+        {
+            ThreadPoolExecutor Pool(4);
+            Pool.Spawn(Consume(Shared,16,First,FirstCorrupted));
+            Pool.Spawn(Consume(Shared,1,Second,SecondCorrupted));
+            for(int i=0; i<3 ;i++) Pool.Spawn(Produce(Shared,i * 10000,i * 10000 + 9999,Producers));
+            Pool.Join();
+        }
+        std::vector<int> All(First);
+        All.insert(All.end(),Second.begin(),Second.end());
+        std::sort(All.begin(),All.end());
+        bool Complete = All.size() == 30000;
+        for(unsigned i=0; i<All.size() && Complete ;i++) Complete = All[i] == static_cast<int>(i);
+        if(!Complete || FirstCorrupted + SecondCorrupted != 0) std::cout << "Elements are lost or duplicated by a channel shared by several threads." << std::endl;
+    }
+#endif
+
+
+    //****************************** test zone 17 ****************************  (Testing following functions: MemoryUsage, Compact, NodeArena::Trim.)
+    std::cout << "-Test Zone 17-\n" << std::endl;
+
+    {
+        Ring<int,std::string> Footprint;
+        RingMemory EmptyUsage = Footprint.MemoryUsage();
+        if(EmptyUsage.NodeBytes == 0 || EmptyUsage.PayloadBytes != 0) std::cout << "MemoryUsage does not count only the sentinel of an empty list." << std::endl;
+        for(int i=0; i<10 ;i++) Footprint.PushBack(i,"short");
+        RingMemory ShortUsage = Footprint.MemoryUsage();
+        TestEqual(ShortUsage.NodeBytes,EmptyUsage.NodeBytes * 11,"MemoryUsage does not count one node for every element and the sentinel.");
+        TestEqual(ShortUsage.PayloadBytes,size_t(0),"MemoryUsage counts a payload for strings stored inside the string object.");
+        Footprint.PushBack(10,std::string(100,'x'));
+        RingMemory LongUsage = Footprint.MemoryUsage();
+        if(LongUsage.PayloadBytes < 101) std::cout << "MemoryUsage does not count the heap buffer of a long string." << std::endl;
+        TestEqual(LongUsage.Total(),LongUsage.NodeBytes + LongUsage.PayloadBytes + LongUsage.SlackBytes,"Total of MemoryUsage is not the sum of its parts.");
+        TestEqual(PayloadSize<std::vector<std::string>>::Of(std::vector<std::string>(2,std::string(100,'x'))) >= 2 * sizeof(std::string) + 202,true,"PayloadSize does not count the elements of a vector.");
+
+        Ring<int,std::string> Churned;
+        for(int i=0; i<2000 ;i++) Churned.PushBack(i,std::to_string(i));
+        for(int i=0; i<2000 ;i+=3) Churned.Erase(Churned.LookFor(i));
+        for(int i=0; i<500 ;i++) Churned.Insert(Churned.LookFor(i * 3 + 1),-i,std::string(40,'y'));
+        Ring<int,std::string> Expected(Churned);
+        Churned.Compact();
+        if(ImproperConnect(Churned) || Churned != Expected) std::cout << "Result of using Compact on a list allocated from the heap is not as expected." << std::endl;
+        TestEqual(Churned.MemoryUsage().PayloadBytes,Expected.MemoryUsage().PayloadBytes,"Compact changes the payloads of the list.");
+
+        NodeArena Small(-1,64 * 1024);
+        Ring<int,std::string> Fragmented(&Small);
+        for(int i=0; i<2000 ;i++) Fragmented.PushBack(i,std::to_string(i));
+        for(int i=0; i<2000 ;i++) if(i % 10 != 0) Fragmented.Erase(Fragmented.LookFor(i));
+        size_t Reserved = Small.ReservedBytes();
+        Fragmented.Compact();
+        if(Small.ReservedBytes() >= Reserved) std::cout << "Compact does not release the chunks of the NodeArena left without nodes." << std::endl;
+        size_t FragmentedNodes = Fragmented.Length() + 1;
+        TestEqual(Small.UsedBytes(),NodeArena::BlockSize(Fragmented.MemoryUsage().NodeBytes / FragmentedNodes) * FragmentedNodes,"NodeArena does not hold exactly the nodes of the list after using Compact.");
+        bool Ordered = true;
+        for(Ring<int,std::string>::Iterator temp = Fragmented.GetFirst(); temp != Fragmented.GetLast() ;++temp){
+            if(temp.pointer->next < temp.pointer) Ordered = false;
+        }
+        if(!Ordered) std::cout << "Nodes are not placed in traversal order after using Compact." << std::endl;
+        if(ImproperConnect(Fragmented) || Fragmented.Length() != 200 || Fragmented.GetLast().pointer->label != 1990) std::cout << "Result of using Compact on a list allocated from a NodeArena is not as expected." << std::endl;
+
+        NodeArena Spare(-1,4096);
+        Ring<int,FragileInfo> Interrupted(&Spare);
+        for(int i=0; i<50 ;i++) Interrupted.PushBack(i,FragileInfo(i));
+        FragileInfo::MovesLeft = 50 + 5;
+        bool Thrown = false;
+        try{
+            Interrupted.Compact();
+        }
+        catch(const std::runtime_error&){
+            Thrown = true;
+        }
+        FragileInfo::MovesLeft = -1;
+        if(!Thrown || ImproperConnect(Interrupted) || Interrupted.Length() != 5 || Interrupted.GetLast().pointer->value.value != 4) std::cout << "Compact does not keep the elements rebuilt before a node failed to build." << std::endl;
+        size_t InterruptedNodes = Interrupted.Length() + 1;
+        TestEqual(Spare.UsedBytes(),NodeArena::BlockSize(Interrupted.MemoryUsage().NodeBytes / InterruptedNodes) * InterruptedNodes,"Compact leaks the block of a node which failed to build.");
+        Interrupted.PushBack(5,FragileInfo(5));
+        if(ImproperConnect(Interrupted) || Interrupted.Length() != 6) std::cout << "List can not be used after Compact failed to build a node." << std::endl;
+
+        NodeArena Holding(-1,4096);
+        Ring<int,FragileInfo> Unmoved(&Holding);
+        for(int i=0; i<50 ;i++) Unmoved.PushBack(i,FragileInfo(i));
+        FragileInfo::MovesLeft = 10;
+        Thrown = false;
+        try{
+            Unmoved.Compact();
+        }
+        catch(const std::runtime_error&){
+            Thrown = true;
+        }
+        FragileInfo::MovesLeft = -1;
+        if(!Thrown || ImproperConnect(Unmoved) || Unmoved.Length() != 40 || Unmoved.GetFirst().pointer->label != 10 || Unmoved.GetLast().pointer->label != 49) std::cout << "Compact does not keep the elements it did not move out before a move failed." << std::endl;
+        size_t UnmovedNodes = Unmoved.Length() + 1;
+        TestEqual(Holding.UsedBytes(),NodeArena::BlockSize(Unmoved.MemoryUsage().NodeBytes / UnmovedNodes) * UnmovedNodes,"Compact leaks nodes after a move failed.");
+
+        NodeArena Shared(-1,4096);
+        Ring<int,int> Stays(&Shared);
+        for(int i=0; i<100 ;i++) Stays.PushBack(i,i);
+        Ring<int,int> Leaves(&Shared);
+        for(int i=0; i<1000 ;i++) Leaves.PushBack(i,i);
+        Leaves.Clear();
+        if(Shared.Trim() == 0) std::cout << "Trim does not release chunks without blocks in use." << std::endl;
+        for(int i=0; i<100 ;i++) Leaves.PushBack(i,i);
+        if(Stays != Leaves || ImproperConnect(Stays)) std::cout << "Trim releases chunks holding blocks in use." << std::endl;
+    }
+
+
     std::cout << "\nEnd of Tests (^w^)" << std::endl;
 
 
@@ -6,7 +6,9 @@
 
 #include <iostream>
 #include "bi_ring.h"
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 
 //This function tests if two values are equal and returns false along a message if they are not, and true otherwise.
@@ -71,6 +73,54 @@ bool TestIf(const T& arg, bool (Check)(const T&), std::string message){
 }
 
 
+//This function returns true if two Rings with unique keys hold the same elements regardless of their order, and false otherwise.
+template<typename Key, typename Info>
+bool SameElements(const Ring<Key, Info>& first, const Ring<Key, Info>& second){
+    if(first.Length() != second.Length()) return false;
+    typename Ring<Key, Info>::ConstIterator it = first.GetFirst();
+    for(unsigned i=0; i<first.Length() ;i++,++it){
+        typename Ring<Key, Info>::Iterator found = second.LookFor(&it);
+        if(found.pointer == nullptr || found == second.GetFirst().pointer->prev || !(found.pointer->value == *it)) return false;
+    }
+    return true;
+}
+
+
+//This structure is a key type which can only be compared with == and <, and not hashed, used to test the functions which pick how keys are stored by what the key supports.
+struct OrderedKey{
+    int id;
+    OrderedKey(int x = 0) : id(x){}
+    bool operator==(const OrderedKey& other) const{ return id == other.id; }
+    bool operator<(const OrderedKey& other) const{ return id < other.id; }
+};
+
+
+//This structure is an info type whose move constructor throws once MovesLeft reaches 0 (a negative MovesLeft never throws), used to test that a Ring stays consistent when
+//building one of its nodes fails.
+struct FragileInfo{
+    static inline int MovesLeft = -1;
+    int value;
+    FragileInfo(int x = 0) : value(x){}
+    FragileInfo(const FragileInfo& src) = default;
+    FragileInfo(FragileInfo&& src) : value(src.value){
+        if(MovesLeft == 0) throw std::runtime_error("FragileInfo ran out of moves");
+        if(MovesLeft > 0) MovesLeft--;
+    }
+    FragileInfo& operator=(const FragileInfo& src) = default;
+    bool operator==(const FragileInfo& other) const{ return value == other.value; }
+    bool operator!=(const FragileInfo& other) const{ return value != other.value; }
+};
+
+
+//This function returns true if a batch of iterators holds, for each key of a batch, the iterator that LookFor returns for it, and false otherwise.
+template<typename Key, typename Info>
+bool MatchesLookFor(const Ring<Key, Info>& src, const std::vector<Key>& keys, const std::vector<typename Ring<Key, Info>::Iterator>& found){
+    if(keys.size() != found.size()) return false;
+    for(unsigned i=0; i<keys.size() ;i++) if(src.LookFor(keys[i]) != found[i]) return false;
+    return true;
+}
+
+
 //This function artificially fills the list with n many default values.
 template<typename Key, typename Info>
 void FillRing(Ring<Key, Info>& src,const int& n){
@@ -79,4 +129,32 @@ void FillRing(Ring<Key, Info>& src,const int& n){
 
 
 
+#if defined(__cpp_impl_coroutine)
+#include <atomic>
+#include "ring_channel.h"
+
+
+//This coroutine pushes the keys from first to last into a channel, with twice the key as info, and closes the channel if it's the last of the producers left.
+inline ChannelTask Produce(RingChannel<int, int>& channel, int first, int last, std::atomic<int>& producersLeft){
+    for(int i=first; i<=last ;i++) co_await channel.Push(i,2 * i);
+    if(--producersLeft == 0) channel.Close();
+}
+
+
+//This coroutine pops batches of up to batch many elements from a channel until it's closed and empty, and adds their keys to received. It counts the elements whose info isn't
+//twice their key in corrupted.
+inline ChannelTask Consume(RingChannel<int, int>& channel, unsigned int batch, std::vector<int>& received, int& corrupted){
+    while(true){
+        std::vector<std::pair<int, int>> Taken = co_await channel.PopBatch(batch);
+        if(Taken.empty()) break;
+        for(const auto& element : Taken){
+            received.push_back(element.first);
+            if(element.second != 2 * element.first) corrupted++;
+        }
+    }
+}
+#endif
+
+
+
 #endif // TEST
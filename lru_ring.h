@@ -0,0 +1,272 @@
+#ifndef LRU_RING
+
+#include <assert.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "bi_ring.h"
+
+#define LRU_RING
+
+
+//This enumeration represents the eviction policies supported by the LruRing class. Under LRU an element is moved to the front of the Ring every time it's read or
+//written, so the element evicted is the least recently used one. Under FIFO elements keep the position they were inserted at, so the element evicted is the oldest one.
+enum class Eviction{ LRU, FIFO };
+
+
+//This class represents a bounded cache built on top of the Ring class. The most recent element is kept at the beginning of the Ring and the element due for eviction is
+//kept at the end, so eviction is a single PopBack. A hash index from keys to iterators allows for getting and putting elements in O(1) instead of walking the Ring with LookFor.
+//Keys are unique within the cache. The Key type must be usable with std::hash.
+template<typename Key, typename Info>
+class LruRing{
+
+public:
+
+    typedef typename Ring<Key,Info>::Iterator Iterator;
+    typedef std::function<void(const Key&, const Info&)> Callback;
+
+private:
+
+    Ring<Key,Info> Items;
+    std::unordered_map<Key,Iterator> Index;
+    unsigned int Capacity;
+    Eviction Policy;
+    Callback OnEvict;
+
+    void Evict();
+
+public:
+
+    //Constructor
+    LruRing(unsigned int capacity, Eviction policy = Eviction::LRU, Callback onEvict = nullptr) : Capacity(capacity), Policy(policy), OnEvict(onEvict){
+        assert(capacity > 0);
+        Index.reserve(capacity);
+    }
+
+
+    //The index holds iterators into the Ring owned by this object, so copying it would leave the copy pointing into the original.
+    LruRing(const LruRing& src) = delete;
+    LruRing& operator=(const LruRing& other) = delete;
+
+
+    //This function returns an iterator pointing to the most recent element in the cache.
+    Iterator GetFirst() const{ return Items.GetFirst(); }
+
+
+    //This function returns an iterator pointing to the element which is next in line for eviction.
+    Iterator GetLast() const{ return Items.GetLast(); }
+
+
+    //This function returns the number of elements currently present in the cache.
+    unsigned int Length() const{ return Items.Length(); }
+
+
+    //This function returns the maximum number of elements the cache can hold before evicting.
+    unsigned int GetCapacity() const{ return Capacity; }
+
+
+    //This function returns true if the cache is empty, and false otherwise.
+    bool IsEmpty() const{ return Items.IsEmpty(); }
+
+
+    //This function returns true if an element with the given key is present in the cache, and false otherwise. It does not count as a use of the element.
+    bool Contains(const Key& ID) const{ return Index.find(ID) != Index.end(); }
+
+
+    //This function returns the Ring holding the elements of the cache, ordered from the most recent to the next in line for eviction.
+    const Ring<Key,Info>& Contents() const{ return Items; }
+
+
+    Iterator Get(const Key& ID);
+
+
+
+    Iterator Put(const Key& ID, const Info& Data);
+
+
+
+    Iterator Touch(const Iterator& item);
+
+
+
+    bool Erase(const Key& ID);
+
+
+
+    void SetCapacity(unsigned int capacity);
+
+
+
+    void Clear();
+
+
+
+    void Print() const{ Items.Print(); }
+
+};
+
+
+//This function removes the element at the end of the Ring, passing it to the eviction callback first if one was given.
+template<typename Key, typename Info>
+void LruRing<Key,Info>::Evict(){
+    Iterator victim = Items.GetLast();
+    if(OnEvict) OnEvict(victim.pointer->label,victim.pointer->value);
+    Index.erase(victim.pointer->label);
+    Items.PopBack();
+}
+
+
+//This function returns an iterator to the element with the given key, or nullptr if it's not in the cache. Under LRU the element is moved to the beginning of the Ring.
+template<typename Key, typename Info>
+typename LruRing<Key,Info>::Iterator LruRing<Key,Info>::Get(const Key& ID){
+    auto found = Index.find(ID);
+    if(found == Index.end()) return nullptr;
+    if(Policy == Eviction::LRU) Items.Touch(found->second);
+    return found->second;
+}
+
+
+//This function sets the info of the element with the given key, adding it to the beginning of the Ring if it's not already in the cache. If adding it makes the cache exceed
+//its capacity, the element at the end of the Ring is evicted. Under LRU an existing element is also moved to the beginning of the Ring. It returns an iterator to the element.
+template<typename Key, typename Info>
+typename LruRing<Key,Info>::Iterator LruRing<Key,Info>::Put(const Key& ID, const Info& Data){
+    auto found = Index.find(ID);
+    if(found != Index.end()){
+        Items.Update(found->second,Data);
+        if(Policy == Eviction::LRU) Items.Touch(found->second);
+        return found->second;
+    }
+
+    Iterator NewItem = Items.PushFront(ID,Data);
+    Index.emplace(ID,NewItem);
+    if(Items.Length() > Capacity) this->Evict();
+    return NewItem;
+}
+
+
+//This function moves the element that the iterator passed to it points to, to the beginning of the Ring, regardless of the eviction policy. It returns an iterator to it,
+//or nullptr if the passed iterator is null or points to the sentinel.
+template<typename Key, typename Info>
+typename LruRing<Key,Info>::Iterator LruRing<Key,Info>::Touch(const Iterator& item){
+    return Items.Touch(item);
+}
+
+
+//This function removes the element with the given key from the cache without passing it to the eviction callback. It returns true if such an element was found, and false otherwise.
+template<typename Key, typename Info>
+bool LruRing<Key,Info>::Erase(const Key& ID){
+    auto found = Index.find(ID);
+    if(found == Index.end()) return false;
+    Items.Erase(found->second);
+    Index.erase(found);
+    return true;
+}
+
+
+//This function changes the capacity of the cache, evicting elements from the end of the Ring until the cache fits within the new capacity.
+template<typename Key, typename Info>
+void LruRing<Key,Info>::SetCapacity(unsigned int capacity){
+    assert(capacity > 0);
+    Capacity = capacity;
+    while(Items.Length() > Capacity) this->Evict();
+}
+
+
+//This function removes all the elements from the cache without passing them to the eviction callback.
+template<typename Key, typename Info>
+void LruRing<Key,Info>::Clear(){
+    Items.Clear();
+    Index.clear();
+}
+
+
+//This class represents an LruRing split into several independently locked shards, so that threads working on different keys don't contend for a single lock. Each key is
+//assigned to a shard by its hash, and the total capacity is split as evenly as possible between the shards (the first capacity % shards shards hold one more element), so the
+//shards never hold more than capacity elements together, and eviction is per shard rather than global. Since iterators would outlive the shard lock, elements are read by
+//copying their info out. The eviction callback is run while the lock of the evicting shard is held.
+template<typename Key, typename Info>
+class ShardedLruRing{
+
+public:
+
+    typedef typename LruRing<Key,Info>::Callback Callback;
+
+private:
+
+    struct Shard{
+        std::mutex Lock;
+        LruRing<Key,Info> Cache;
+
+        Shard(unsigned int capacity, Eviction policy, Callback onEvict) : Cache(capacity,policy,onEvict){}
+    };
+
+    std::vector<std::unique_ptr<Shard>> Shards;
+
+    Shard& ShardOf(const Key& ID) const{
+        size_t hash = std::hash<Key>()(ID);
+        return *Shards[(hash ^ (hash >> 16)) % Shards.size()];
+    }
+
+public:
+
+    //Constructor
+    ShardedLruRing(unsigned int capacity, unsigned int shards = 16, Eviction policy = Eviction::LRU, Callback onEvict = nullptr){
+        assert(shards > 0 && capacity >= shards);
+        Shards.reserve(shards);
+        for(unsigned i=0; i<shards ;i++) Shards.emplace_back(new Shard(capacity / shards + (i < capacity % shards ? 1 : 0),policy,onEvict));
+    }
+
+
+    //This function copies the info of the element with the given key into Data and returns true, or returns false if the key is not in the cache.
+    bool Get(const Key& ID, Info& Data){
+        Shard& owner = this->ShardOf(ID);
+        std::lock_guard<std::mutex> guard(owner.Lock);
+        typename LruRing<Key,Info>::Iterator found = owner.Cache.Get(ID);
+        if(found.pointer == nullptr) return false;
+        Data = found.pointer->value;
+        return true;
+    }
+
+
+    //This function sets the info of the element with the given key, adding it to the cache if it's not already there.
+    void Put(const Key& ID, const Info& Data){
+        Shard& owner = this->ShardOf(ID);
+        std::lock_guard<std::mutex> guard(owner.Lock);
+        owner.Cache.Put(ID,Data);
+    }
+
+
+    //This function removes the element with the given key from the cache. It returns true if such an element was found, and false otherwise.
+    bool Erase(const Key& ID){
+        Shard& owner = this->ShardOf(ID);
+        std::lock_guard<std::mutex> guard(owner.Lock);
+        return owner.Cache.Erase(ID);
+    }
+
+
+    //This function returns the number of elements currently present in all the shards. Shards are counted one at a time, so the result is only a snapshot under concurrent use.
+    unsigned int Length() const{
+        unsigned int Count = 0;
+        for(const auto& owner : Shards){
+            std::lock_guard<std::mutex> guard(owner->Lock);
+            Count += owner->Cache.Length();
+        }
+        return Count;
+    }
+
+
+    //This function removes all the elements from all the shards without passing them to the eviction callback.
+    void Clear(){
+        for(auto& owner : Shards){
+            std::lock_guard<std::mutex> guard(owner->Lock);
+            owner->Cache.Clear();
+        }
+    }
+
+};
+
+
+
+#endif // LRU_RING
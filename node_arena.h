@@ -0,0 +1,292 @@
+#ifndef NODE_ARENA
+
+#include <assert.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define NODE_ARENA
+
+
+//This class represents a memory arena which hands out fixed size blocks for the nodes of one or more Rings. Memory is reserved in large chunks (2MB by default, the size of
+//a huge page on x86-64) and blocks are carved out of each chunk in the order they are requested, so nodes allocated one after the other are next to each other in memory.
+//Freed blocks are kept in a free list per block size and reused before the chunk is grown. Chunks are only returned to the system by Trim, once none of their blocks is in use.
+//On Linux each chunk is first requested from explicit huge pages (MAP_HUGETLB). If none are available it falls back to normal pages marked with MADV_HUGEPAGE, so that
+//transparent huge pages can back it. If a NUMA node is given, each chunk is bound to that node with mbind before it's first touched. When binding fails (for example when the
+//node doesn't exist on a single node machine) the chunk is used as is, so the NUMA policy silently becomes a no-op. On other systems chunks come from the global heap.
+//The arena is not thread safe and it must outlive every Ring using it. All memory is returned to the system when the arena is destroyed.
+class NodeArena{
+
+private:
+    struct Chunk{
+        char* base;
+        size_t used;
+        bool mapped;
+    };
+
+    struct FreeBlock{
+        FreeBlock* next;
+    };
+
+    struct FreeList{
+        size_t bytes;
+        FreeBlock* head;
+    };
+
+    std::vector<Chunk> Chunks;
+    std::vector<FreeList> FreeLists;
+    size_t ChunkBytes;
+    int NumaNode;
+    bool HugePages = true;
+    bool NumaBound = true;
+    size_t LiveBytes = 0;
+
+    static const size_t BlockAlign = 16;
+
+    FreeList& FreeListOf(size_t bytes){
+        for(FreeList& list : FreeLists) if(list.bytes == bytes) return list;
+        FreeLists.push_back(FreeList{bytes,nullptr});
+        return FreeLists.back();
+    }
+
+    void Grow();
+
+    void Release(Chunk& chunk);
+
+public:
+
+    static const size_t HugePageBytes = size_t(2) << 20;
+
+
+    //This function returns the number of bytes of the block the arena hands out for a request of the given number of bytes.
+    static size_t BlockSize(size_t bytes){
+        if(bytes < sizeof(FreeBlock)) bytes = sizeof(FreeBlock);
+        return (bytes + BlockAlign - 1) / BlockAlign * BlockAlign;
+    }
+
+
+    //Constructor. A negative numaNode leaves placement to the operating system.
+    explicit NodeArena(int numaNode = -1, size_t chunkBytes = HugePageBytes) : ChunkBytes(chunkBytes), NumaNode(numaNode){
+        assert(chunkBytes >= BlockAlign);
+    }
+
+
+    //The arena owns the chunks its blocks live in, so it can't be copied.
+    NodeArena(const NodeArena& src) = delete;
+    NodeArena& operator=(const NodeArena& other) = delete;
+
+
+    //Destructor
+    ~NodeArena(){
+        for(Chunk& chunk : Chunks) this->Release(chunk);
+    }
+
+
+    void* Allocate(size_t bytes, size_t align);
+
+
+
+    void* AllocateFresh(size_t bytes, size_t align);
+
+
+
+    void Deallocate(void* block, size_t bytes);
+
+
+
+    size_t Trim();
+
+
+
+    //This function returns the NUMA node the arena was asked to bind its chunks to, or a negative number if none was given.
+    int GetNumaNode() const{ return NumaNode; }
+
+
+    //This function returns true if every chunk reserved so far is backed by explicit huge pages, and false otherwise.
+    bool UsesHugePages() const{ return !Chunks.empty() && HugePages; }
+
+
+    //This function returns true if every chunk reserved so far was bound to the requested NUMA node, and false if no node was requested or binding failed.
+    bool IsNumaBound() const{ return NumaNode >= 0 && NumaBound; }
+
+
+    //This function returns the number of bytes reserved from the system by the arena.
+    size_t ReservedBytes() const{ return Chunks.size() * ChunkBytes; }
+
+
+    //This function returns the number of bytes in blocks which are currently handed out by the arena.
+    size_t UsedBytes() const{ return LiveBytes; }
+
+};
+
+
+//This function reserves a new chunk, trying explicit huge pages first and then normal pages, and binds it to the NUMA node of the arena if one was given.
+inline void NodeArena::Grow(){
+    Chunk chunk{nullptr,0,false};
+
+#if defined(__linux__)
+    void* base = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    if(ChunkBytes % HugePageBytes == 0) base = mmap(nullptr,ChunkBytes,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,-1,0);
+#endif
+    if(base == MAP_FAILED){
+        HugePages = false;
+        base = mmap(nullptr,ChunkBytes,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+        if(base == MAP_FAILED) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+        madvise(base,ChunkBytes,MADV_HUGEPAGE);
+#endif
+    }
+    chunk.base = static_cast<char*>(base);
+    chunk.mapped = true;
+
+    if(NumaNode >= 0){
+        bool bound = false;
+#if defined(SYS_mbind)
+        const unsigned long BindPolicy = 2;
+        const unsigned long BitsPerMask = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(NumaNode / BitsPerMask + 1,0);
+        mask[NumaNode / BitsPerMask] = 1UL << (NumaNode % BitsPerMask);
+        bound = syscall(SYS_mbind,chunk.base,ChunkBytes,BindPolicy,mask.data(),mask.size() * BitsPerMask + 1,0) == 0;
+#endif
+        if(!bound) NumaBound = false;
+    }
+#else
+    HugePages = false;
+    NumaBound = false;
+    chunk.base = static_cast<char*>(::operator new(ChunkBytes));
+#endif
+
+    Chunks.push_back(chunk);
+}
+
+
+//This function returns a chunk to the system.
+inline void NodeArena::Release(Chunk& chunk){
+#if defined(__linux__)
+    if(chunk.mapped) munmap(chunk.base,ChunkBytes);
+    else ::operator delete(chunk.base);
+#else
+    ::operator delete(chunk.base);
+#endif
+    chunk.base = nullptr;
+}
+
+
+//This function returns a block of at least the given number of bytes with at least the given alignment (at most 16). Freed blocks of the same size are reused first, otherwise the
+//block is taken from the end of the last chunk, reserving a new chunk when it's full.
+inline void* NodeArena::Allocate(size_t bytes, size_t align){
+    assert(align <= BlockAlign);
+    size_t size = BlockSize(bytes);
+    assert(size <= ChunkBytes);
+    (void)align;
+
+    FreeList& list = this->FreeListOf(size);
+    LiveBytes += size;
+    if(list.head){
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        return block;
+    }
+
+    if(Chunks.empty() || Chunks.back().used + size > ChunkBytes) this->Grow();
+    Chunk& chunk = Chunks.back();
+    void* block = chunk.base + chunk.used;
+    chunk.used += size;
+    return block;
+}
+
+
+//This function returns a block like Allocate, but always from the start of a newly reserved chunk, so the blocks taken from the end of the last chunk afterwards follow it in
+//memory. The rest of the chunk which was last before is not used anymore.
+inline void* NodeArena::AllocateFresh(size_t bytes, size_t align){
+    assert(align <= BlockAlign);
+    size_t size = BlockSize(bytes);
+    assert(size <= ChunkBytes);
+    (void)align;
+
+    this->Grow();
+    Chunk& chunk = Chunks.back();
+    chunk.used = size;
+    LiveBytes += size;
+    return chunk.base;
+}
+
+
+//This function returns a block given out by Allocate with the same number of bytes to the arena so it can be reused.
+inline void NodeArena::Deallocate(void* block, size_t bytes){
+    if(!block) return;
+    size_t size = BlockSize(bytes);
+    FreeList& list = this->FreeListOf(size);
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = list.head;
+    list.head = freed;
+    LiveBytes -= size;
+}
+
+
+
+//This function returns every chunk none of whose blocks is in use to the system, dropping their blocks from the free lists, and returns the number of bytes released. Finding
+//the chunk of each free block takes O(f log c) for f free blocks and c chunks, so it's meant to be called after many blocks were freed, not after every Deallocate.
+//Blocks are allocated from fresh chunks afterwards, so a Ring whose nodes were all freed before the call gets consecutive blocks again.
+inline size_t NodeArena::Trim(){
+    std::vector<size_t> Order(Chunks.size());
+    for(size_t i=0; i<Order.size() ;i++) Order[i] = i;
+    std::sort(Order.begin(),Order.end(),[this](size_t arg1, size_t arg2){ return Chunks[arg1].base < Chunks[arg2].base; });
+
+    auto ChunkOf = [this,&Order](const char* block){
+        size_t low = 0;
+        size_t high = Order.size();
+        while(high - low > 1){
+            size_t middle = (low + high) / 2;
+            if(Chunks[Order[middle]].base <= block) low = middle;
+            else high = middle;
+        }
+        return Order[low];
+    };
+
+    std::vector<size_t> FreeBytes(Chunks.size(),0);
+    for(FreeList& list : FreeLists){
+        for(FreeBlock* block = list.head; block ;block = block->next) FreeBytes[ChunkOf(reinterpret_cast<char*>(block))] += list.bytes;
+    }
+
+    std::vector<bool> Empty(Chunks.size(),false);
+    bool AnyEmpty = false;
+    for(size_t i=0; i<Chunks.size() ;i++){
+        Empty[i] = FreeBytes[i] == Chunks[i].used;
+        AnyEmpty = AnyEmpty || Empty[i];
+    }
+    if(!AnyEmpty) return 0;
+
+    for(FreeList& list : FreeLists){
+        FreeBlock** link = &list.head;
+        while(*link){
+            if(Empty[ChunkOf(reinterpret_cast<char*>(*link))]) *link = (*link)->next;
+            else link = &(*link)->next;
+        }
+    }
+
+    size_t Released = 0;
+    std::vector<Chunk> Kept;
+    for(size_t i=0; i<Chunks.size() ;i++){
+        if(Empty[i]){
+            this->Release(Chunks[i]);
+            Released += ChunkBytes;
+        }
+        else Kept.push_back(Chunks[i]);
+    }
+    Chunks.swap(Kept);
+    return Released;
+}
+
+
+
+#endif // NODE_ARENA
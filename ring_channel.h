@@ -0,0 +1,490 @@
+#ifndef RING_CHANNEL
+
+#if defined(__cpp_impl_coroutine)
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "bi_ring.h"
+
+#endif
+
+#define RING_CHANNEL
+
+#if defined(__cpp_impl_coroutine)
+
+
+class ChannelExecutor;
+
+
+//This class represents a coroutine which is run by a ChannelExecutor. It does nothing until it's handed to ChannelExecutor::Spawn, and it destroys itself when it finishes.
+//Only coroutines of this type can wait on a RingChannel, since a waiting coroutine is resumed on the executor it was spawned on.
+class ChannelTask{
+
+public:
+
+    struct promise_type;
+
+    //This structure destroys the coroutine when it finishes and then tells its executor.
+    struct FinalAwaiter{
+        bool await_ready() const noexcept{ return false; }
+        void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+        void await_resume() const noexcept{}
+    };
+
+    struct promise_type{
+        ChannelExecutor* executor = nullptr;
+        ChannelTask get_return_object(){ return ChannelTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() const noexcept{ return {}; }
+        FinalAwaiter final_suspend() const noexcept{ return {}; }
+        void return_void() const{}
+        void unhandled_exception() const{ std::terminate(); }
+    };
+
+private:
+
+    std::coroutine_handle<promise_type> Handle;
+
+    explicit ChannelTask(std::coroutine_handle<promise_type> handle) : Handle(handle){}
+
+    friend class ChannelExecutor;
+
+public:
+
+    //A task owns its coroutine until it's spawned, so it can only be moved.
+    ChannelTask(ChannelTask&& src) : Handle(std::exchange(src.Handle,nullptr)){}
+    ChannelTask(const ChannelTask& src) = delete;
+    ChannelTask& operator=(const ChannelTask& other) = delete;
+
+
+    //Destructor. A task which was never spawned is destroyed without running.
+    ~ChannelTask(){
+        if(Handle) Handle.destroy();
+    }
+
+};
+
+
+//This class is the interface of the executors which run ChannelTasks. Schedule is called with every coroutine which is ready to run, both when it's spawned and when a RingChannel
+//wakes it up, and it may be called from any thread.
+class ChannelExecutor{
+
+private:
+
+    std::atomic<unsigned int> Live{0};
+
+    friend struct ChannelTask::FinalAwaiter;
+
+protected:
+
+    //This function is called after a task spawned on the executor has finished and was destroyed.
+    virtual void Finished(){ --Live; }
+
+public:
+
+    virtual ~ChannelExecutor(){}
+
+
+    //This function queues a coroutine to be resumed by the executor.
+    virtual void Schedule(std::coroutine_handle<> handle) = 0;
+
+
+    //This function hands a task to the executor, which starts running it.
+    void Spawn(ChannelTask task){
+        task.Handle.promise().executor = this;
+        ++Live;
+        this->Schedule(std::exchange(task.Handle,nullptr));
+    }
+
+
+    //This function returns the number of tasks spawned on the executor which haven't finished yet.
+    unsigned int Running() const{ return Live; }
+
+};
+
+
+//This function destroys a finished coroutine and tells the executor it was spawned on.
+inline void ChannelTask::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept{
+    ChannelExecutor* executor = handle.promise().executor;
+    handle.destroy();
+    if(executor) executor->Finished();
+}
+
+
+//This class represents an executor which runs its tasks on the thread calling Run, one at a time, switching between them only when one waits on a channel.
+class SingleThreadExecutor : public ChannelExecutor{
+
+private:
+
+    std::mutex Lock;
+    std::deque<std::coroutine_handle<>> Ready;
+
+public:
+
+    //This function queues a coroutine to be resumed by Run.
+    void Schedule(std::coroutine_handle<> handle) override{
+        std::lock_guard<std::mutex> locked(Lock);
+        Ready.push_back(handle);
+    }
+
+
+    //This function resumes queued coroutines until none is left, and returns the number of tasks which haven't finished, all of them waiting on a channel. It returns 0 once
+    //every task has finished. Tasks waiting on a channel fed by another executor are resumed by a later call of Run.
+    unsigned int Run(){
+        while(true){
+            std::coroutine_handle<> Next;
+            {
+                std::lock_guard<std::mutex> locked(Lock);
+                if(Ready.empty()) break;
+                Next = Ready.front();
+                Ready.pop_front();
+            }
+            Next.resume();
+        }
+        return this->Running();
+    }
+
+};
+
+
+//This class represents an executor which runs its tasks on a fixed number of worker threads. Idle workers sleep on a condition variable, so nothing is polled.
+//The executor must not be destroyed while some of its tasks wait on a channel, since they are never resumed.
+class ThreadPoolExecutor : public ChannelExecutor{
+
+private:
+
+    std::mutex Lock;
+    std::condition_variable Wake;
+    std::condition_variable Idle;
+    std::deque<std::coroutine_handle<>> Ready;
+    std::vector<std::thread> Workers;
+    bool Stopping = false;
+
+    void Work();
+
+protected:
+
+    //This function wakes up Join when the last task finishes. It notifies while holding the lock, since Join may return and the executor be destroyed as soon as it's released.
+    void Finished() override{
+        std::lock_guard<std::mutex> locked(Lock);
+        ChannelExecutor::Finished();
+        Idle.notify_all();
+    }
+
+public:
+
+    //Constructor. It starts the given number of worker threads, or one per hardware thread if it's 0.
+    explicit ThreadPoolExecutor(unsigned int threads = 0){
+        if(threads == 0) threads = std::max(1u,std::thread::hardware_concurrency());
+        for(unsigned i=0; i<threads ;i++) Workers.emplace_back([this](){ this->Work(); });
+    }
+
+
+    //The workers hold the address of the executor, so it can't be copied.
+    ThreadPoolExecutor(const ThreadPoolExecutor& src) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor& other) = delete;
+
+
+    //Destructor. It stops the workers after the coroutines already queued have run.
+    ~ThreadPoolExecutor(){
+        {
+            std::lock_guard<std::mutex> locked(Lock);
+            Stopping = true;
+        }
+        Wake.notify_all();
+        for(std::thread& worker : Workers) worker.join();
+    }
+
+
+    //This function queues a coroutine to be resumed by one of the workers.
+    void Schedule(std::coroutine_handle<> handle) override{
+        {
+            std::lock_guard<std::mutex> locked(Lock);
+            Ready.push_back(handle);
+        }
+        Wake.notify_one();
+    }
+
+
+    //This function waits until every task spawned on the executor has finished.
+    void Join(){
+        std::unique_lock<std::mutex> locked(Lock);
+        Idle.wait(locked,[this](){ return this->Running() == 0; });
+    }
+
+};
+
+
+//This function is run by every worker. It resumes queued coroutines and sleeps while there are none.
+inline void ThreadPoolExecutor::Work(){
+    std::unique_lock<std::mutex> locked(Lock);
+    while(true){
+        Wake.wait(locked,[this](){ return Stopping || !Ready.empty(); });
+        if(Ready.empty()) return;
+        std::coroutine_handle<> Next = Ready.front();
+        Ready.pop_front();
+        locked.unlock();
+        Next.resume();
+        locked.lock();
+    }
+}
+
+
+//This class represents a bounded channel which passes elements from producer coroutines to consumer coroutines in order, buffering them in a Ring.
+//co_await Push(key, info) waits while the channel holds Capacity elements, so a fast producer is held back by a slow consumer instead of filling memory. co_await Pop() waits
+//while the channel is empty, and co_await PopBatch(n) takes up to n elements in a single resume. A waiting coroutine is suspended and queued on the channel, and the coroutine
+//which frees a slot or adds an element schedules it on the executor it was spawned on, so nothing busy waits. An element pushed while a consumer waits is handed to it
+//directly, without going through the Ring.
+//After Close, pushes fail at once and pops drain what's left, then return nothing. The channel may be shared by coroutines on any number of executors and threads. It must
+//outlive every coroutine waiting on it.
+template<typename Key, typename Info>
+class RingChannel{
+
+public:
+
+    typedef std::pair<Key,Info> Element;
+
+    class PushAwaiter;
+    class PopBatchAwaiter;
+    class PopAwaiter;
+
+private:
+
+    //This structure holds a coroutine to be resumed once the lock of the channel is released.
+    struct Waking{
+        ChannelExecutor* executor;
+        std::coroutine_handle<> handle;
+    };
+
+    Ring<Key,Info> Buffer;
+    unsigned int Capacity;
+    bool Closed = false;
+    mutable std::mutex Lock;
+    std::deque<PushAwaiter*> Pushers;
+    std::deque<PopBatchAwaiter*> Poppers;
+
+    void Take(PopBatchAwaiter* popper, std::vector<Waking>& woken);
+
+    static void WakeAll(const std::vector<Waking>& woken){
+        for(const Waking& waiter : woken) waiter.executor->Schedule(waiter.handle);
+    }
+
+public:
+
+    //This class is the result of Push. Awaiting it gives true once the element is in the channel, or false if the channel was closed.
+    class PushAwaiter{
+
+    private:
+        RingChannel* Channel;
+        Key ID;
+        Info Data;
+        ChannelExecutor* Executor = nullptr;
+        std::coroutine_handle<> Handle;
+        bool Accepted = false;
+
+        friend class RingChannel;
+
+    public:
+        PushAwaiter(RingChannel* channel, const Key& id, const Info& data) : Channel(channel), ID(id), Data(data){}
+
+        bool await_ready() const{ return false; }
+
+        bool await_suspend(std::coroutine_handle<ChannelTask::promise_type> handle);
+
+        bool await_resume() const{ return Accepted; }
+
+    };
+
+
+    //This class is the result of PopBatch. Awaiting it gives at least one element, or no elements if the channel was closed and is empty.
+    class PopBatchAwaiter{
+
+    protected:
+        RingChannel* Channel;
+        unsigned int Max;
+        std::vector<Element> Taken;
+        ChannelExecutor* Executor = nullptr;
+        std::coroutine_handle<> Handle;
+
+        friend class RingChannel;
+
+    public:
+        PopBatchAwaiter(RingChannel* channel, unsigned int max) : Channel(channel), Max(max){ assert(max > 0); }
+
+        bool await_ready() const{ return false; }
+
+        bool await_suspend(std::coroutine_handle<ChannelTask::promise_type> handle);
+
+        std::vector<Element> await_resume();
+
+    };
+
+
+    //This class is the result of Pop. Awaiting it gives an element, or nothing if the channel was closed and is empty.
+    class PopAwaiter : public PopBatchAwaiter{
+
+    public:
+        explicit PopAwaiter(RingChannel* channel) : PopBatchAwaiter(channel,1){}
+
+        std::optional<Element> await_resume(){
+            if(this->Taken.empty()) return std::nullopt;
+            return std::move(this->Taken.front());
+        }
+
+    };
+
+
+    //Constructor. capacity is the largest number of elements the channel buffers before Push waits.
+    explicit RingChannel(unsigned int capacity) : Capacity(capacity){ assert(capacity > 0); }
+
+
+    //Coroutines wait on the channel by address, so it can't be copied.
+    RingChannel(const RingChannel& src) = delete;
+    RingChannel& operator=(const RingChannel& other) = delete;
+
+
+    //This function returns an awaitable which adds an element with the given key and info to the end of the channel.
+    PushAwaiter Push(const Key& ID, const Info& Data){ return PushAwaiter(this,ID,Data); }
+
+
+    //This function returns an awaitable which removes the first element of the channel.
+    PopAwaiter Pop(){ return PopAwaiter(this); }
+
+
+    //This function returns an awaitable which removes up to max elements from the front of the channel.
+    PopBatchAwaiter PopBatch(unsigned int max){ return PopBatchAwaiter(this,max); }
+
+
+    void Close();
+
+
+
+    //This function returns the number of elements currently buffered in the channel.
+    unsigned int Length() const{
+        std::lock_guard<std::mutex> locked(Lock);
+        return Buffer.Length();
+    }
+
+
+    //This function returns true if the channel was closed, and false otherwise.
+    bool IsClosed() const{
+        std::lock_guard<std::mutex> locked(Lock);
+        return Closed;
+    }
+
+};
+
+
+//This function moves up to the number of elements the popper asks for from the front of the buffer into it, and then fills the freed slots with the elements of waiting
+//pushers, which are added to woken. The lock must be held.
+template<typename Key, typename Info>
+void RingChannel<Key,Info>::Take(PopBatchAwaiter* popper, std::vector<Waking>& woken){
+    while(popper->Taken.size() < popper->Max && !Buffer.IsEmpty()){
+        typename Ring<Key,Info>::Iterator temp = Buffer.GetFirst();
+        popper->Taken.emplace_back(temp.pointer->label,temp.pointer->value);
+        Buffer.PopFront();
+    }
+    while(!Pushers.empty() && Buffer.Length() < Capacity){
+        PushAwaiter* pusher = Pushers.front();
+        Pushers.pop_front();
+        Buffer.PushBack(pusher->ID,pusher->Data);
+        pusher->Accepted = true;
+        woken.push_back(Waking{pusher->Executor,pusher->Handle});
+    }
+}
+
+
+//This function adds the element to the channel, handing it straight to a waiting consumer if there is one. The coroutine is only suspended if the channel is full.
+template<typename Key, typename Info>
+bool RingChannel<Key,Info>::PushAwaiter::await_suspend(std::coroutine_handle<ChannelTask::promise_type> handle){
+    Waking Consumer{nullptr,nullptr};
+    {
+        std::lock_guard<std::mutex> locked(Channel->Lock);
+        if(Channel->Closed) return false;
+        Accepted = true;
+        if(!Channel->Poppers.empty()){
+            PopBatchAwaiter* popper = Channel->Poppers.front();
+            Channel->Poppers.pop_front();
+            popper->Taken.emplace_back(ID,Data);
+            Consumer = Waking{popper->Executor,popper->Handle};
+        }
+        else if(Channel->Buffer.Length() < Channel->Capacity) Channel->Buffer.PushBack(ID,Data);
+        else{
+            Accepted = false;
+            Executor = handle.promise().executor;
+            Handle = handle;
+            assert(Executor);
+            Channel->Pushers.push_back(this);
+            return true;
+        }
+    }
+    if(Consumer.executor) Consumer.executor->Schedule(Consumer.handle);
+    return false;
+}
+
+
+//This function takes elements from the channel. The coroutine is only suspended if the channel is empty and open.
+template<typename Key, typename Info>
+bool RingChannel<Key,Info>::PopBatchAwaiter::await_suspend(std::coroutine_handle<ChannelTask::promise_type> handle){
+    std::vector<Waking> Woken;
+    {
+        std::lock_guard<std::mutex> locked(Channel->Lock);
+        Channel->Take(this,Woken);
+        if(Taken.empty() && !Channel->Closed){
+            Executor = handle.promise().executor;
+            Handle = handle;
+            assert(Executor);
+            Channel->Poppers.push_back(this);
+            return true;
+        }
+    }
+    WakeAll(Woken);
+    return false;
+}
+
+
+//This function returns the elements taken. A consumer woken up by a producer was handed a single element, so it takes whatever else is buffered up to its limit before
+//returning.
+template<typename Key, typename Info>
+std::vector<typename RingChannel<Key,Info>::Element> RingChannel<Key,Info>::PopBatchAwaiter::await_resume(){
+    if(!Taken.empty() && Taken.size() < Max){
+        std::vector<Waking> Woken;
+        {
+            std::lock_guard<std::mutex> locked(Channel->Lock);
+            Channel->Take(this,Woken);
+        }
+        WakeAll(Woken);
+    }
+    return std::move(Taken);
+}
+
+
+//This function closes the channel. Waiting producers are woken up with their elements refused, and waiting consumers, which only wait while the channel is empty, are woken
+//up with nothing.
+template<typename Key, typename Info>
+void RingChannel<Key,Info>::Close(){
+    std::vector<Waking> Woken;
+    {
+        std::lock_guard<std::mutex> locked(Lock);
+        Closed = true;
+        for(PushAwaiter* pusher : Pushers) Woken.push_back(Waking{pusher->Executor,pusher->Handle});
+        for(PopBatchAwaiter* popper : Poppers) Woken.push_back(Waking{popper->Executor,popper->Handle});
+        Pushers.clear();
+        Poppers.clear();
+    }
+    WakeAll(Woken);
+}
+
+
+#endif // __cpp_impl_coroutine
+
+#endif // RING_CHANNEL
@@ -0,0 +1,561 @@
+#ifndef RING_JOURNAL
+
+#include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bi_ring.h"
+
+#define RING_JOURNAL
+
+
+//This structure describes how keys and infos are written to and read back from a journal. The general version copies the bytes of the value, so it only works for trivially
+//copyable types. Other types need a specialization with the same two functions, like the one for std::string below.
+template<typename T>
+struct JournalCodec{
+
+    static_assert(std::is_trivially_copyable<T>::value, "Types which are not trivially copyable need a JournalCodec specialization to be journaled.");
+
+    //This function appends a value to the end of a buffer.
+    static void Write(std::string& out, const T& item){ out.append(reinterpret_cast<const char*>(&item),sizeof(T)); }
+
+    //This function reads a value from the start of a buffer and moves past it. It returns false if the buffer ends too soon, and true otherwise.
+    static bool Read(const char*& from, const char* end, T& item){
+        if(static_cast<size_t>(end - from) < sizeof(T)) return false;
+        std::memcpy(&item,from,sizeof(T));
+        from += sizeof(T);
+        return true;
+    }
+
+};
+
+
+//This specialization writes strings as their length followed by their characters.
+template<>
+struct JournalCodec<std::string>{
+
+    //This function appends a value to the end of a buffer.
+    static void Write(std::string& out, const std::string& item){
+        JournalCodec<uint32_t>::Write(out,item.size());
+        out.append(item);
+    }
+
+    //This function reads a value from the start of a buffer and moves past it. It returns false if the buffer ends too soon, and true otherwise.
+    static bool Read(const char*& from, const char* end, std::string& item){
+        uint32_t length;
+        if(!JournalCodec<uint32_t>::Read(from,end,length) || static_cast<size_t>(end - from) < length) return false;
+        item.assign(from,length);
+        from += length;
+        return true;
+    }
+
+};
+
+
+//This structure holds the settings of a RingJournal which trade the latency of a change reaching the disk for throughput.
+struct JournalOptions{
+    //The longest time in microseconds a record waits for more records to be committed with it.
+    unsigned int CommitMicroseconds = 1000;
+    //The number of waiting bytes which makes the writer commit right away.
+    size_t CommitBytes = size_t(1) << 16;
+    //The number of bytes of records added to the log since the last snapshot which makes the journal replace it with a new snapshot of the Ring, or 0 to only do so when
+    //Compact is called. Since the threshold doesn't include the snapshot itself, a large Ring isn't snapshotted again after every change.
+    size_t CompactBytes = size_t(64) << 20;
+    //Whether every commit is followed by fdatasync. Without it records survive a crash of the process but not of the machine.
+    bool Sync = true;
+};
+
+
+//This class represents a write-ahead journal which makes the changes to a Ring survive a crash. It subscribes to the Ring as an observer and turns each change into a small binary
+//record, which is only added to a buffer on the thread changing the Ring. A background thread writes the buffer to the log file and syncs it, so all the records that arrived
+//while the previous commit was running are committed together with a single fdatasync (group commit).
+//Each record is its length, then the operation, the id of the element it changes (or, for an insertion, of the element it's inserted before), the key and info, and finally a
+//checksum, so a record torn by a crash is detected and recovery stops there. Elements get consecutive ids in the order they are added, starting from 0 with every snapshot,
+//and Replay hands them out the same way. The journal finds the id of an element in a hash table from its node, so every change is recorded in O(1), at the cost of one
+//table entry per element. When the journal is attached, and again whenever CompactBytes of records were added after the last snapshot or Compact
+//is called, the log is replaced by a snapshot of the whole Ring.
+//Key and Info must have a JournalCodec. The Ring must only be changed by one thread at a time, and the journal must be destroyed before its Ring or right after it.
+template<typename Key, typename Info>
+class RingJournal : public Ring<Key,Info>::Observer{
+
+public:
+
+    typedef typename Ring<Key,Info>::Iterator Iterator;
+
+private:
+
+    enum Operation : uint8_t{ OpPushFront = 1, OpPushBack, OpInsert, OpErase, OpUpdate, OpClear, OpTouch, OpRotate };
+
+    struct Batch{
+        bool snapshot;
+        std::string bytes;
+    };
+
+    Ring<Key,Info>* Source;
+    std::unordered_map<const void*,uint64_t> Ids;
+    uint64_t NextId = 0;
+    std::string Path;
+    JournalOptions Options;
+    int Descriptor = -1;
+
+    std::mutex Lock;
+    std::condition_variable Wake;
+    std::condition_variable Done;
+    std::deque<Batch> Queue;
+    size_t QueuedBytes = 0;
+    size_t LogBytes = 0;
+    size_t SnapshotBytes = 0;
+    unsigned long long Snapshots = 0;
+    unsigned long long Appended = 0;
+    unsigned long long Durable = 0;
+    unsigned int Flushing = 0;
+    bool Stopping = false;
+    bool Failed = false;
+    std::thread Writer;
+
+    static uint32_t Checksum(const char* from, size_t length);
+
+    static void Frame(std::string& out, const std::string& body);
+
+    uint64_t IdOf(const Iterator& item) const;
+
+    std::string Snapshot();
+
+    void Append(const std::string& bytes, bool snapshot);
+
+    void Record(Operation op, const Iterator& item, bool withId, uint64_t id, bool withKey, bool withInfo);
+
+    void CompactIfLarge();
+
+    void WriterLoop();
+
+    bool WriteAll(int descriptor, const std::string& bytes);
+
+    bool WriteSnapshot(const std::string& bytes);
+
+public:
+
+    //Constructor. It replaces whatever the log file holds with a snapshot of the current contents of the Ring, so a Ring recovered with Replay should be passed here to carry on
+    //journaling it. It throws std::runtime_error if the log file can't be written.
+    RingJournal(Ring<Key,Info>& source, const std::string& path, JournalOptions options = JournalOptions()) : Source(&source), Path(path), Options(options){
+        std::string First = this->Snapshot();
+        if(!this->WriteSnapshot(First)) throw std::runtime_error("RingJournal: can't write log file " + path);
+        LogBytes = SnapshotBytes = First.size();
+        Snapshots = 1;
+        Writer = std::thread([this](){ this->WriterLoop(); });
+        source.Subscribe(this);
+    }
+
+
+    //The journal is subscribed to its Ring by address and owns the log file, so it can't be copied.
+    RingJournal(const RingJournal& src) = delete;
+    RingJournal& operator=(const RingJournal& other) = delete;
+
+
+    //Destructor. Every record is committed before the journal stops.
+    ~RingJournal(){
+        if(Source) Source->Unsubscribe(this);
+        {
+            std::lock_guard<std::mutex> locked(Lock);
+            Stopping = true;
+        }
+        Wake.notify_one();
+        Writer.join();
+        if(Descriptor >= 0) close(Descriptor);
+    }
+
+
+    bool Flush();
+
+
+
+    void Compact();
+
+
+
+    static unsigned int Replay(const std::string& path, Ring<Key,Info>& target);
+
+
+
+    //This function returns the number of snapshots the log was replaced with so far, counting the one written when the journal was attached.
+    unsigned long long SnapshotCount(){
+        std::lock_guard<std::mutex> locked(Lock);
+        return Snapshots;
+    }
+
+
+    //This function returns false if writing to the log has failed at some point, and true otherwise.
+    bool IsHealthy(){
+        std::lock_guard<std::mutex> locked(Lock);
+        return !Failed;
+    }
+
+
+    void Inserted(const Iterator& item) override;
+
+
+
+    void Erasing(const Iterator& item) override;
+
+
+
+    void Updated(const Iterator& item, const Info&) override;
+
+
+
+    void Cleared() override;
+
+
+
+    void Touching(const Iterator& item) override;
+
+
+
+    void Rotating(const Iterator& item) override;
+
+
+
+    //This function replaces the log with a snapshot once the Ring moved its elements into new nodes, since the ids of the elements are looked up by node.
+    void Relocated() override{ this->Compact(); }
+
+
+
+    void Detached() override{ Source = nullptr; }
+
+};
+
+
+//This function returns the FNV-1a hash of a range of bytes, used to detect torn or corrupted records.
+template<typename Key, typename Info>
+uint32_t RingJournal<Key,Info>::Checksum(const char* from, size_t length){
+    uint32_t hash = 2166136261u;
+    for(size_t i=0; i<length ;i++){
+        hash ^= static_cast<unsigned char>(from[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+//This function appends a record with the given body to a buffer, surrounded by its length and checksum.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Frame(std::string& out, const std::string& body){
+    JournalCodec<uint32_t>::Write(out,body.size());
+    out.append(body);
+    JournalCodec<uint32_t>::Write(out,Checksum(body.data(),body.size()));
+}
+
+
+//This function returns the id of an element of the Ring.
+template<typename Key, typename Info>
+uint64_t RingJournal<Key,Info>::IdOf(const Iterator& item) const{
+    auto found = Ids.find(item.pointer);
+    assert(found != Ids.end());
+    return found->second;
+}
+
+
+//This function returns the records which rebuild the current contents of the Ring from an empty Ring, and gives the elements new ids in order, as Replay will.
+template<typename Key, typename Info>
+std::string RingJournal<Key,Info>::Snapshot(){
+    std::string out;
+    std::string body;
+    Ids.clear();
+    NextId = 0;
+    Iterator temp = Source->GetFirst();
+    for(unsigned i=0; i<Source->Length() ;i++,++temp){
+        body.assign(1,static_cast<char>(OpPushBack));
+        JournalCodec<Key>::Write(body,temp.pointer->label);
+        JournalCodec<Info>::Write(body,temp.pointer->value);
+        Frame(out,body);
+        Ids.emplace(temp.pointer,NextId++);
+    }
+    return out;
+}
+
+
+//This function hands framed records to the writer thread. A snapshot replaces the log instead of being added to it. The writer is only woken up when it has to be, so most changes
+//don't make any system call.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Append(const std::string& bytes, bool snapshot){
+    bool WasIdle;
+    bool Full;
+    {
+        std::lock_guard<std::mutex> locked(Lock);
+        WasIdle = Queue.empty();
+        if(snapshot || Queue.empty() || Queue.back().snapshot) Queue.push_back(Batch{snapshot,std::string()});
+        Queue.back().bytes.append(bytes);
+        QueuedBytes += bytes.size();
+        LogBytes = snapshot ? bytes.size() : LogBytes + bytes.size();
+        if(snapshot){
+            SnapshotBytes = bytes.size();
+            ++Snapshots;
+        }
+        ++Appended;
+        Full = QueuedBytes >= Options.CommitBytes;
+    }
+    if(WasIdle || Full || snapshot) Wake.notify_one();
+}
+
+
+//This function turns a change to the element the iterator points to into a record, with the given id if withId is true, and hands it to the writer thread.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Record(Operation op, const Iterator& item, bool withId, uint64_t id, bool withKey, bool withInfo){
+    std::string body(1,static_cast<char>(op));
+    if(withId) JournalCodec<uint64_t>::Write(body,id);
+    if(withKey) JournalCodec<Key>::Write(body,item.pointer->label);
+    if(withInfo) JournalCodec<Info>::Write(body,item.pointer->value);
+    std::string framed;
+    Frame(framed,body);
+    this->Append(framed,false);
+}
+
+
+//This function replaces the log with a snapshot of the Ring if more than CompactBytes of records were added since the last snapshot. Each snapshot is then paid for by at least
+//CompactBytes of records, however large the Ring is. It's only called after a change, when the Ring matches the records so far.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::CompactIfLarge(){
+    if(Options.CompactBytes == 0) return;
+    bool Large;
+    {
+        std::lock_guard<std::mutex> locked(Lock);
+        Large = LogBytes - SnapshotBytes > Options.CompactBytes;
+    }
+    if(Large) this->Compact();
+}
+
+
+//This function records an element added to the Ring.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Inserted(const Iterator& item){
+    if(item == Source->GetFirst()) this->Record(OpPushFront,item,false,0,true,true);
+    else if(item == Source->GetLast()) this->Record(OpPushBack,item,false,0,true,true);
+    else this->Record(OpInsert,item,true,this->IdOf(item.pointer->next),true,true);
+    Ids.emplace(item.pointer,NextId++);
+    this->CompactIfLarge();
+}
+
+
+//This function records the new info of an element of the Ring.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Updated(const Iterator& item, const Info&){
+    this->Record(OpUpdate,item,true,this->IdOf(item),false,true);
+    this->CompactIfLarge();
+}
+
+
+//This function records an element about to be removed from the Ring. The Ring still matches the log at this point, so the log is compacted first if it grew too large, the
+//same way as for Touching and Rotating.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Erasing(const Iterator& item){
+    this->CompactIfLarge();
+    auto found = Ids.find(item.pointer);
+    assert(found != Ids.end());
+    this->Record(OpErase,item,true,found->second,false,false);
+    Ids.erase(found);
+}
+
+
+//This function records an element about to be moved to the beginning of the Ring by Touch.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Touching(const Iterator& item){
+    this->CompactIfLarge();
+    this->Record(OpTouch,item,true,this->IdOf(item),false,false);
+}
+
+
+//This function records the Ring about to be rotated so that an element becomes the first one.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Rotating(const Iterator& item){
+    this->CompactIfLarge();
+    this->Record(OpRotate,item,true,this->IdOf(item),false,false);
+}
+
+
+//This function records the Ring being cleared.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Cleared(){
+    std::string framed;
+    Ids.clear();
+    Frame(framed,std::string(1,static_cast<char>(OpClear)));
+    this->Append(framed,false);
+}
+
+
+//This function replaces the log with a snapshot of the current contents of the Ring. The snapshot is taken on the calling thread, which must be the one changing the Ring, and
+//written by the writer thread in order with the other records.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::Compact(){
+    if(Source) this->Append(this->Snapshot(),true);
+}
+
+
+//This function waits until every change recorded so far is committed to the log. It returns false if writing to the log has failed, and true otherwise.
+template<typename Key, typename Info>
+bool RingJournal<Key,Info>::Flush(){
+    std::unique_lock<std::mutex> locked(Lock);
+    unsigned long long Target = Appended;
+    ++Flushing;
+    Wake.notify_one();
+    Done.wait(locked,[this,Target](){ return Durable >= Target || Failed; });
+    --Flushing;
+    return !Failed;
+}
+
+
+//This function is run by the writer thread. It waits for records, gives more records CommitMicroseconds to arrive unless enough bytes are already waiting or someone is waiting on
+//Flush, and then writes and syncs everything that arrived in one go.
+template<typename Key, typename Info>
+void RingJournal<Key,Info>::WriterLoop(){
+    std::unique_lock<std::mutex> locked(Lock);
+    while(true){
+        Wake.wait(locked,[this](){ return Stopping || !Queue.empty(); });
+        if(Queue.empty()) break;
+
+        Wake.wait_for(locked,std::chrono::microseconds(Options.CommitMicroseconds),[this](){
+            return Stopping || Flushing > 0 || QueuedBytes >= Options.CommitBytes;
+        });
+
+        std::deque<Batch> Taken;
+        Taken.swap(Queue);
+        QueuedBytes = 0;
+        unsigned long long Target = Appended;
+        locked.unlock();
+
+        bool Written = true;
+        for(const Batch& batch : Taken){
+            if(batch.snapshot) Written = this->WriteSnapshot(batch.bytes) && Written;
+            else Written = this->WriteAll(Descriptor,batch.bytes) && Written;
+        }
+        if(Options.Sync && Descriptor >= 0 && fdatasync(Descriptor) != 0) Written = false;
+
+        locked.lock();
+        Durable = Target;
+        if(!Written) Failed = true;
+        Done.notify_all();
+    }
+}
+
+
+//This function writes a whole buffer to a file, retrying partial writes. It returns false if the write fails, and true otherwise.
+template<typename Key, typename Info>
+bool RingJournal<Key,Info>::WriteAll(int descriptor, const std::string& bytes){
+    size_t Written = 0;
+    while(Written < bytes.size()){
+        ssize_t Count = write(descriptor,bytes.data() + Written,bytes.size() - Written);
+        if(Count < 0) return false;
+        Written += Count;
+    }
+    return true;
+}
+
+
+//This function replaces the log file with one holding only the given snapshot. The snapshot is written to a temporary file which is synced and then renamed over the log, so a
+//crash at any point leaves either the old log or the new one in place. It returns false if any step fails, and true otherwise.
+template<typename Key, typename Info>
+bool RingJournal<Key,Info>::WriteSnapshot(const std::string& bytes){
+    std::string Temporary = Path + ".tmp";
+    int descriptor = open(Temporary.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+    if(descriptor < 0) return false;
+    bool Written = this->WriteAll(descriptor,bytes) && fsync(descriptor) == 0;
+    close(descriptor);
+    if(!Written || rename(Temporary.c_str(),Path.c_str()) != 0) return false;
+
+    size_t Slash = Path.find_last_of('/');
+    std::string Directory = Slash == std::string::npos ? "." : (Slash == 0 ? "/" : Path.substr(0,Slash));
+    int directory = open(Directory.c_str(),O_RDONLY);
+    if(directory >= 0){
+        fsync(directory);
+        close(directory);
+    }
+
+    descriptor = open(Path.c_str(),O_WRONLY | O_APPEND);
+    if(descriptor < 0) return false;
+    if(Descriptor >= 0) close(Descriptor);
+    Descriptor = descriptor;
+    return true;
+}
+
+
+//This function rebuilds a Ring from a log file by applying its records in order to the given Ring, which should be empty. It stops at the first record which is incomplete,
+//doesn't match its checksum or names an element which doesn't exist, since that's where a crash interrupted the writer. It returns the number of records applied, which is 0 if the file doesn't exist.
+template<typename Key, typename Info>
+unsigned int RingJournal<Key,Info>::Replay(const std::string& path, Ring<Key,Info>& target){
+    int descriptor = open(path.c_str(),O_RDONLY);
+    if(descriptor < 0) return 0;
+    std::string bytes;
+    char Buffer[1 << 16];
+    ssize_t Count;
+    while((Count = read(descriptor,Buffer,sizeof(Buffer))) > 0) bytes.append(Buffer,Count);
+    close(descriptor);
+
+    std::unordered_map<uint64_t,Iterator> Nodes;
+    uint64_t NextId = 0;
+    unsigned int Applied = 0;
+    const char* from = bytes.data();
+    const char* end = bytes.data() + bytes.size();
+    while(true){
+        uint32_t length;
+        uint32_t sum = 0;
+        if(!JournalCodec<uint32_t>::Read(from,end,length) || static_cast<size_t>(end - from) < length + sizeof(uint32_t)) break;
+        const char* body = from;
+        const char* bodyEnd = from + length;
+        from = bodyEnd;
+        JournalCodec<uint32_t>::Read(from,end,sum);
+        if(length == 0 || sum != Checksum(body,length)) break;
+
+        Operation op = static_cast<Operation>(*body++);
+        uint64_t id = 0;
+        Key ID;
+        Info Data;
+        bool Valid = true;
+        Iterator item = nullptr;
+        if(op == OpInsert || op == OpErase || op == OpUpdate || op == OpTouch || op == OpRotate){
+            Valid = JournalCodec<uint64_t>::Read(body,bodyEnd,id);
+            auto found = Nodes.find(id);
+            if(found == Nodes.end()) Valid = false;
+            else item = found->second;
+        }
+        if(Valid && (op == OpPushFront || op == OpPushBack || op == OpInsert)) Valid = JournalCodec<Key>::Read(body,bodyEnd,ID);
+        if(Valid && (op == OpPushFront || op == OpPushBack || op == OpInsert || op == OpUpdate)) Valid = JournalCodec<Info>::Read(body,bodyEnd,Data);
+        if(!Valid) break;
+
+        switch(op){
+            case OpPushFront: Nodes.emplace(NextId++,target.PushFront(ID,Data)); break;
+            case OpPushBack: Nodes.emplace(NextId++,target.PushBack(ID,Data)); break;
+            case OpInsert: Nodes.emplace(NextId++,target.Insert(item,ID,Data)); break;
+            case OpErase:
+                target.Erase(item);
+                Nodes.erase(id);
+                break;
+            case OpUpdate: target.Update(item,Data); break;
+            case OpClear:
+                target.Clear();
+                Nodes.clear();
+                break;
+            case OpTouch: target.Touch(item); break;
+            case OpRotate: target.RotateTo(item); break;
+            default: Valid = false;
+        }
+        if(!Valid) break;
+        ++Applied;
+    }
+
+    return Applied;
+}
+
+
+
+#endif // RING_JOURNAL
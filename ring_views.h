@@ -0,0 +1,326 @@
+#ifndef RING_VIEWS
+
+#include <assert.h>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bi_ring.h"
+
+#define RING_VIEWS
+
+
+//This trait tells whether the difference of two values of a type can be taken with operator-. It is used by JoinView to decide whether sums can be undone when an element is removed.
+template<typename T, typename = void>
+struct IsSubtractable : std::false_type{};
+
+template<typename T>
+struct IsSubtractable<T, decltype(void(std::declval<const T&>() - std::declval<const T&>()))> : std::true_type{};
+
+
+//This class represents the result of Unique on a source Ring, kept up to date as the source changes instead of being computed again from scratch. The view subscribes to the
+//source and updates a single element of its result for every change, using a hash index from keys to the elements of the result.
+//Since elements are aggregated in the order the changes arrive, rather than in the order of the source, the aggregate must be commutative and associative for the result to match
+//Unique, and elements of the result are ordered by when their key first appeared. If an inverse is given, inverse(key, aggregate, info) must undo adding info to the aggregate, and
+//removals and updates take O(1). Otherwise the aggregate of the key is computed again from the source, which takes O(n) for that change only.
+//Elements written to directly through Iterator::pointer of the source are not seen by the view, so call Resync afterwards. If such a write changed the key of an element, the
+//view finds out when the element is changed or removed, and builds its result again from the source.
+//The Key type must be usable with std::hash. If the source is destroyed before the view, the view keeps its last result.
+template<typename Key, typename Info>
+class UniqueView : public Ring<Key,Info>::Observer{
+
+public:
+
+    typedef typename Ring<Key,Info>::Iterator Iterator;
+    typedef std::function<Info(const Key&, const Info&, const Info&)> Aggregate;
+    typedef std::function<void(const Key&)> Listener;
+
+private:
+
+    struct Group{
+        Iterator item;
+        unsigned int count;
+    };
+
+    Ring<Key,Info>* Source;
+    Ring<Key,Info> Result;
+    std::unordered_map<Key,Group> Groups;
+    Aggregate Combine;
+    Aggregate Inverse;
+    Listener OnChange;
+
+    void Add(const Key& ID, const Info& Data);
+
+    bool Subtract(const Iterator& item, const Info& Data, bool erased);
+
+    void Recompute(const Key& ID, const Iterator& excluded);
+
+    void Rebuild(const Iterator& excluded);
+
+    void Changed(const Key& ID){ if(OnChange) OnChange(ID); }
+
+public:
+
+    //Constructor. The view starts out holding the result of Unique on the current contents of the source.
+    UniqueView(Ring<Key,Info>& source, Aggregate aggregate, Aggregate inverse = nullptr) : Source(&source), Combine(aggregate), Inverse(inverse){
+        assert(Combine);
+        source.Scan([this](const Key& ID, const Info& Data){ this->Add(ID,Data); });
+        source.Subscribe(this);
+    }
+
+
+    //The view is subscribed to its source by address, so it can't be copied.
+    UniqueView(const UniqueView& src) = delete;
+    UniqueView& operator=(const UniqueView& other) = delete;
+
+
+    //Destructor
+    ~UniqueView(){
+        if(Source) Source->Unsubscribe(this);
+    }
+
+
+    //This function returns the Ring holding the current result of the view.
+    const Ring<Key,Info>& GetResult() const{ return Result; }
+
+
+    //This function returns an iterator to the element of the result with the given key, or nullptr if the source has no element with that key.
+    Iterator Find(const Key& ID) const{
+        auto found = Groups.find(ID);
+        if(found == Groups.end()) return nullptr;
+        return found->second.item;
+    }
+
+
+    //This function returns true while the source exists, and false after it was destroyed.
+    bool IsAttached() const{ return Source != nullptr; }
+
+
+    //This function sets a function which is called with the key of every element of the result after it's added, changed or removed.
+    void SetListener(Listener listener){ OnChange = listener; }
+
+
+    //This function builds the result again from the source. It's only needed after elements of the source were changed directly through Iterator::pointer.
+    void Resync(){
+        if(Source) this->Rebuild(nullptr);
+    }
+
+
+    void Inserted(const Iterator& item) override;
+
+
+
+    void Erasing(const Iterator& item) override;
+
+
+
+    void Updated(const Iterator& item, const Info& Old) override;
+
+
+
+    void Cleared() override;
+
+
+
+    void Detached() override{ Source = nullptr; }
+
+};
+
+
+//This function adds an info to the aggregate of its key, adding the key to the result if it's new.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Add(const Key& ID, const Info& Data){
+    auto found = Groups.find(ID);
+    if(found == Groups.end()) Groups.emplace(ID,Group{Result.PushBack(ID,Data),1});
+    else{
+        Result.Update(found->second.item,Combine(ID,found->second.item.pointer->value,Data));
+        ++found->second.count;
+    }
+}
+
+
+//This function removes an info from the aggregate of the key of the given source element, removing the key from the result if it was its last element. If the element is
+//still in the source (erased is true when it's about to be removed) it's left out when the aggregate has to be computed again. If the view doesn't know the key, because it
+//was written to through Iterator::pointer, the whole result is built again instead and false is returned. Otherwise it returns true.
+template<typename Key, typename Info>
+bool UniqueView<Key,Info>::Subtract(const Iterator& item, const Info& Data, bool erased){
+    const Key& ID = item.pointer->label;
+    auto found = Groups.find(ID);
+    if(found == Groups.end()){
+        this->Rebuild(erased ? item : Iterator(nullptr));
+        return false;
+    }
+
+    if(erased && --found->second.count == 0){
+        Result.Erase(found->second.item);
+        Groups.erase(found);
+    }
+    else if(Inverse) Result.Update(found->second.item,Inverse(ID,found->second.item.pointer->value,Data));
+    else this->Recompute(ID,erased ? item : Iterator(nullptr));
+    return true;
+}
+
+
+//This function computes the aggregate of a key again by going through the source, leaving out the excluded element.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Recompute(const Key& ID, const Iterator& excluded){
+    auto found = Groups.find(ID);
+    if(found == Groups.end()){
+        this->Rebuild(excluded);
+        return;
+    }
+    Iterator Target = found->second.item;
+    bool First = true;
+    Info Total = Info();
+
+    Iterator temp = Source->GetFirst();
+    for(unsigned i=0; i<Source->Length() ;i++,++temp){
+        if(temp == excluded || !(temp.pointer->label == ID)) continue;
+        Total = First ? temp.pointer->value : Combine(ID,Total,temp.pointer->value);
+        First = false;
+    }
+
+    Result.Update(Target,Total);
+}
+
+
+//This function empties the result and adds every element of the source to it again, leaving out the excluded element. The listener is called with every key the result held
+//before or holds now.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Rebuild(const Iterator& excluded){
+    std::vector<Key> Touched;
+    Touched.reserve(Groups.size());
+    for(const auto& entry : Groups) Touched.push_back(entry.first);
+    Groups.clear();
+    Result.Clear();
+
+    Iterator temp = Source->GetFirst();
+    for(unsigned i=0; i<Source->Length() ;i++,++temp){
+        if(temp != excluded) this->Add(temp.pointer->label,temp.pointer->value);
+    }
+
+    for(const auto& entry : Groups) Touched.push_back(entry.first);
+    for(const Key& ID : Touched) this->Changed(ID);
+}
+
+
+//This function adds the info of an element added to the source to the result.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Inserted(const Iterator& item){
+    this->Add(item.pointer->label,item.pointer->value);
+    this->Changed(item.pointer->label);
+}
+
+
+//This function removes the info of an element about to be removed from the source from the result.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Erasing(const Iterator& item){
+    this->Subtract(item,item.pointer->value,true);
+    this->Changed(item.pointer->label);
+}
+
+
+//This function replaces the old info of an element of the source with its new info in the result.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Updated(const Iterator& item, const Info& Old){
+    if(Inverse){
+        if(!this->Subtract(item,Old,false)) return;
+        this->Add(item.pointer->label,item.pointer->value);
+        --Groups.find(item.pointer->label)->second.count;
+    }
+    else this->Recompute(item.pointer->label,nullptr);
+    this->Changed(item.pointer->label);
+}
+
+
+//This function empties the result after the source was cleared.
+template<typename Key, typename Info>
+void UniqueView<Key,Info>::Cleared(){
+    std::vector<Key> Removed;
+    Removed.reserve(Groups.size());
+    for(const auto& entry : Groups) Removed.push_back(entry.first);
+    Groups.clear();
+    Result.Clear();
+    for(const Key& ID : Removed) this->Changed(ID);
+}
+
+
+//This class represents the result of Join on two source Rings, kept up to date as either source changes. It keeps a UniqueView of each source, aggregated with operator+ like
+//Join does, and whenever the aggregate of a key changes in either of them, the single element of the result with that key is updated. If Info supports operator-, removals
+//from the sources are undone in O(1), otherwise the aggregate of the key is computed again from its source. Elements of the result are ordered by when their key first
+//appeared in the first source, and the result matches Join as long as operator+ is commutative and associative for Info.
+template<typename Key, typename Info>
+class JoinView{
+
+public:
+
+    typedef typename Ring<Key,Info>::Iterator Iterator;
+
+private:
+
+    Ring<Key,Info> Result;
+    std::unordered_map<Key,Iterator> Index;
+    UniqueView<Key,Info> First;
+    UniqueView<Key,Info> Second;
+
+    static Info Sum(const Key&, const Info& arg1, const Info& arg2){ return arg1 + arg2; }
+
+    static typename UniqueView<Key,Info>::Aggregate Difference(){
+        if constexpr(IsSubtractable<Info>::value) return [](const Key&, const Info& arg1, const Info& arg2){ return Info(arg1 - arg2); };
+        else return nullptr;
+    }
+
+    void Refresh(const Key& ID);
+
+public:
+
+    //Constructor. The view starts out holding the result of Join on the current contents of the sources.
+    JoinView(Ring<Key,Info>& first, Ring<Key,Info>& second) : First(first,Sum,Difference()), Second(second,Sum,Difference()){
+        First.GetResult().Scan([this](const Key& ID, const Info&){ this->Refresh(ID); });
+        First.SetListener([this](const Key& ID){ this->Refresh(ID); });
+        Second.SetListener([this](const Key& ID){ this->Refresh(ID); });
+    }
+
+
+    //The view is subscribed to its sources by address, so it can't be copied.
+    JoinView(const JoinView& src) = delete;
+    JoinView& operator=(const JoinView& other) = delete;
+
+
+    //This function returns the Ring holding the current result of the view.
+    const Ring<Key,Info>& GetResult() const{ return Result; }
+
+
+    //This function builds the result again from the sources. It's only needed after elements of the sources were changed directly through Iterator::pointer.
+    void Resync(){
+        First.Resync();
+        Second.Resync();
+    }
+
+};
+
+
+//This function brings the element of the result with the given key up to date with the aggregates of that key in both sources.
+template<typename Key, typename Info>
+void JoinView<Key,Info>::Refresh(const Key& ID){
+    Iterator Own = First.Find(ID);
+    auto found = Index.find(ID);
+
+    if(Own.pointer == nullptr){
+        if(found != Index.end()){
+            Result.Erase(found->second);
+            Index.erase(found);
+        }
+        return;
+    }
+
+    Iterator Other = Second.Find(ID);
+    Info Total = Other.pointer ? Info(Own.pointer->value + Other.pointer->value) : Own.pointer->value;
+    if(found == Index.end()) Index.emplace(ID,Result.PushBack(ID,Total));
+    else if(!(found->second.pointer->value == Total)) Result.Update(found->second,Total);
+}
+
+
+
+#endif // RING_VIEWS
@@ -0,0 +1,460 @@
+#ifndef SHM_RING
+
+#include <assert.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SHM_RING
+
+
+//This class represents a doubly linked Ring with a sentinel, like the Ring class, whose sentinel and nodes all live in a POSIX shared memory segment, so several processes can
+//work on the same Ring without copying or serializing it. Each process may map the segment at a different address, so nodes are linked by their offset from the start of the
+//segment instead of by pointers. Nodes come from a pool of fixed capacity inside the segment, and a process shared mutex protects the Ring, which only enters the kernel when
+//two processes contend for it. Since keys and infos are copied into the segment byte for byte, Key and Info must be trivially copyable (no pointers to the heap of a process).
+//The mutex is robust: if a process dies while holding it, the next process to lock it repairs the links and the pool of the Ring from the sentinel, so it loses at most the
+//element that was being added or removed instead of deadlocking. Close tells consumers no more elements will come, so waiting consumers return instead of blocking forever.
+//Only the process which created the segment removes its name when it's destroyed, so the segment lives until every process has unmapped it.
+template<typename Key, typename Info>
+class SharedRing{
+
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Info>::value, "Key and Info of a SharedRing must be trivially copyable.");
+
+private:
+    typedef uint64_t Offset;
+
+    struct Node{
+        Key label;
+        Info value;
+        Offset next;
+        Offset prev;
+    };
+
+    struct Header{
+        uint64_t magic;
+        uint64_t capacity;
+        uint64_t size;
+        uint64_t closed;
+        Offset freeList;
+        pthread_mutex_t lock;
+        pthread_cond_t filled;
+        Node sentinel;
+    };
+
+    static const uint64_t Magic = 0x52494E47534D454DULL;
+
+    std::string Name;
+    char* Base = nullptr;
+    size_t Bytes = 0;
+    bool Owner = false;
+
+    Header* Head() const{ return reinterpret_cast<Header*>(Base); }
+    Node* At(Offset place) const{ return reinterpret_cast<Node*>(Base + place); }
+    Offset OffsetOf(const Node* item) const{ return reinterpret_cast<const char*>(item) - Base; }
+    Offset SentinelOffset() const{ return offsetof(Header,sentinel); }
+
+    static size_t SegmentBytes(uint64_t capacity){ return sizeof(Header) + capacity * sizeof(Node); }
+
+    bool Map(int descriptor, size_t bytes);
+
+    void TakeFront(Key& ID, Info& Data);
+
+    Offset Allocate(const Key& ID, const Info& Data, Offset next, Offset prev);
+
+    void Release(Offset place);
+
+    void Recover() const;
+
+    bool Wait(const timespec* deadline) const;
+
+    //This class locks the mutex of the Ring for as long as it exists, repairing the Ring if the previous owner of the mutex died while holding it.
+    class Guard{
+    private:
+        const SharedRing* Owner;
+    public:
+        explicit Guard(const SharedRing* owner) : Owner(owner){
+            if(pthread_mutex_lock(&Owner->Head()->lock) == EOWNERDEAD) Owner->Recover();
+        }
+        ~Guard(){ pthread_mutex_unlock(&Owner->Head()->lock); }
+    };
+
+    SharedRing(){}
+
+public:
+
+    static SharedRing* Create(const std::string& name, unsigned int capacity, bool replace = false);
+
+
+
+    static SharedRing* Open(const std::string& name);
+
+
+
+    //The mapping is owned by this object, so it can't be copied.
+    SharedRing(const SharedRing& src) = delete;
+    SharedRing& operator=(const SharedRing& other) = delete;
+
+
+    //Destructor. It unmaps the segment, and the process which created it also removes its name.
+    ~SharedRing(){
+        if(Base) munmap(Base,Bytes);
+        if(Owner) shm_unlink(Name.c_str());
+    }
+
+
+    //This function returns the number of elements currently present in the Ring.
+    unsigned int Length() const{
+        Guard locked(this);
+        return Head()->size;
+    }
+
+
+    //This function returns true if the Ring is empty, and false otherwise.
+    bool IsEmpty() const{ return this->Length() == 0; }
+
+
+    //This function returns the largest number of elements the Ring can hold.
+    unsigned int Capacity() const{ return Head()->capacity; }
+
+
+    //This function returns true if the Ring was closed by any process, and false otherwise.
+    bool IsClosed() const{
+        Guard locked(this);
+        return Head()->closed != 0;
+    }
+
+
+    void Close();
+
+
+
+    bool PushBack(const Key& ID, const Info& Data);
+
+
+
+    bool PushFront(const Key& ID, const Info& Data);
+
+
+
+    bool PopFront(Key& ID, Info& Data);
+
+
+
+    bool PopBack(Key& ID, Info& Data);
+
+
+
+    bool WaitPopFront(Key& ID, Info& Data);
+
+
+
+    bool WaitPopFront(Key& ID, Info& Data, unsigned int milliseconds);
+
+};
+
+
+//This function creates a new shared memory segment with the given name (which must start with '/') holding an empty Ring with room for capacity many elements, and returns
+//the Ring mapped into this process. If a segment with that name already exists it throws std::runtime_error, unless replace is true, in which case the name is taken over by
+//the new segment (processes still using the old one keep it, but nobody can open it anymore). It also throws std::runtime_error if the segment can't be created or mapped.
+template<typename Key, typename Info>
+SharedRing<Key,Info>* SharedRing<Key,Info>::Create(const std::string& name, unsigned int capacity, bool replace){
+    assert(capacity > 0);
+    if(replace) shm_unlink(name.c_str());
+    int descriptor = shm_open(name.c_str(),O_CREAT | O_EXCL | O_RDWR,0600);
+    if(descriptor < 0 && errno == EEXIST) throw std::runtime_error("SharedRing: shared memory segment " + name + " already exists");
+    if(descriptor < 0) throw std::runtime_error("SharedRing: can't create shared memory segment " + name);
+    size_t bytes = SegmentBytes(capacity);
+    if(ftruncate(descriptor,bytes) != 0){
+        close(descriptor);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("SharedRing: can't size shared memory segment " + name);
+    }
+
+    SharedRing* NewRing = new SharedRing();
+    NewRing->Name = name;
+    NewRing->Owner = true;
+    if(!NewRing->Map(descriptor,bytes)){
+        delete NewRing;
+        throw std::runtime_error("SharedRing: can't map shared memory segment " + name);
+    }
+
+    Header* head = NewRing->Head();
+    head->capacity = capacity;
+    head->size = 0;
+    head->closed = 0;
+    head->sentinel.next = head->sentinel.prev = NewRing->SentinelOffset();
+
+    head->freeList = 0;
+    for(uint64_t i=capacity; i>0 ;i--){
+        Node* item = reinterpret_cast<Node*>(NewRing->Base + sizeof(Header) + (i - 1) * sizeof(Node));
+        item->next = head->freeList;
+        head->freeList = NewRing->OffsetOf(item);
+    }
+
+    pthread_mutexattr_t lockAttributes;
+    pthread_mutexattr_init(&lockAttributes);
+    pthread_mutexattr_setpshared(&lockAttributes,PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&lockAttributes,PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&head->lock,&lockAttributes);
+    pthread_mutexattr_destroy(&lockAttributes);
+
+    pthread_condattr_t conditionAttributes;
+    pthread_condattr_init(&conditionAttributes);
+    pthread_condattr_setpshared(&conditionAttributes,PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&conditionAttributes,CLOCK_MONOTONIC);
+    pthread_cond_init(&head->filled,&conditionAttributes);
+    pthread_condattr_destroy(&conditionAttributes);
+
+    __atomic_store_n(&head->magic,Magic,__ATOMIC_RELEASE);
+    return NewRing;
+}
+
+
+//This function maps an existing shared memory segment holding a Ring with the same Key and Info types into this process and returns it. It throws std::runtime_error if the
+//segment doesn't exist, can't be mapped, or doesn't hold a fully created Ring.
+template<typename Key, typename Info>
+SharedRing<Key,Info>* SharedRing<Key,Info>::Open(const std::string& name){
+    int descriptor = shm_open(name.c_str(),O_RDWR,0600);
+    if(descriptor < 0) throw std::runtime_error("SharedRing: can't open shared memory segment " + name);
+    struct stat status;
+    if(fstat(descriptor,&status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)){
+        close(descriptor);
+        throw std::runtime_error("SharedRing: shared memory segment " + name + " does not hold a Ring");
+    }
+
+    SharedRing* NewRing = new SharedRing();
+    NewRing->Name = name;
+    if(!NewRing->Map(descriptor,status.st_size)){
+        delete NewRing;
+        throw std::runtime_error("SharedRing: can't map shared memory segment " + name);
+    }
+    if(__atomic_load_n(&NewRing->Head()->magic,__ATOMIC_ACQUIRE) != Magic || SegmentBytes(NewRing->Head()->capacity) != NewRing->Bytes){
+        delete NewRing;
+        throw std::runtime_error("SharedRing: shared memory segment " + name + " does not hold a Ring");
+    }
+    return NewRing;
+}
+
+
+//This function maps the segment behind the given descriptor into this process and closes the descriptor. It returns false if the segment can't be mapped, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::Map(int descriptor, size_t bytes){
+    void* base = mmap(nullptr,bytes,PROT_READ | PROT_WRITE,MAP_SHARED,descriptor,0);
+    close(descriptor);
+    if(base == MAP_FAILED) return false;
+    Base = static_cast<char*>(base);
+    Bytes = bytes;
+    return true;
+}
+
+
+//This function takes a node from the pool, fills it in and returns its offset, or returns 0 if the pool is empty. The lock must be held.
+template<typename Key, typename Info>
+typename SharedRing<Key,Info>::Offset SharedRing<Key,Info>::Allocate(const Key& ID, const Info& Data, Offset next, Offset prev){
+    Header* head = Head();
+    Offset place = head->freeList;
+    if(place == 0) return 0;
+    Node* item = At(place);
+    head->freeList = item->next;
+    item->label = ID;
+    item->value = Data;
+    item->next = next;
+    item->prev = prev;
+    return place;
+}
+
+
+//This function returns a node to the pool. The lock must be held.
+template<typename Key, typename Info>
+void SharedRing<Key,Info>::Release(Offset place){
+    Node* item = At(place);
+    item->next = Head()->freeList;
+    Head()->freeList = place;
+}
+
+
+//This function inserts an element with a given key and info to the end of the Ring. It returns false if the Ring is already at its capacity or was closed, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::PushBack(const Key& ID, const Info& Data){
+    Header* head = Head();
+    Guard locked(this);
+    if(head->closed) return false;
+    Offset sentinel = SentinelOffset();
+    Offset place = this->Allocate(ID,Data,sentinel,head->sentinel.prev);
+    if(place == 0) return false;
+    At(head->sentinel.prev)->next = place;
+    head->sentinel.prev = place;
+    head->size++;
+    pthread_cond_signal(&head->filled);
+    return true;
+}
+
+
+//This function inserts an element with a given key and info to the beginning of the Ring. It returns false if the Ring is already at its capacity or was closed, and true
+//otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::PushFront(const Key& ID, const Info& Data){
+    Header* head = Head();
+    Guard locked(this);
+    if(head->closed) return false;
+    Offset sentinel = SentinelOffset();
+    Offset place = this->Allocate(ID,Data,head->sentinel.next,sentinel);
+    if(place == 0) return false;
+    At(head->sentinel.next)->prev = place;
+    head->sentinel.next = place;
+    head->size++;
+    pthread_cond_signal(&head->filled);
+    return true;
+}
+
+
+//This function removes the first element in the Ring and copies its key and info out. The lock must be held and the Ring must not be empty.
+template<typename Key, typename Info>
+void SharedRing<Key,Info>::TakeFront(Key& ID, Info& Data){
+    Header* head = Head();
+    Offset place = head->sentinel.next;
+    Node* item = At(place);
+    ID = item->label;
+    Data = item->value;
+    head->sentinel.next = item->next;
+    At(item->next)->prev = SentinelOffset();
+    head->size--;
+    this->Release(place);
+}
+
+
+//This function removes the first element in the Ring and copies its key and info out. It returns false without waiting if the Ring is empty, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::PopFront(Key& ID, Info& Data){
+    Header* head = Head();
+    Guard locked(this);
+    if(head->size == 0) return false;
+    this->TakeFront(ID,Data);
+    return true;
+}
+
+
+//This function removes the last element in the Ring and copies its key and info out. It returns false without waiting if the Ring is empty, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::PopBack(Key& ID, Info& Data){
+    Header* head = Head();
+    Guard locked(this);
+    if(head->size == 0) return false;
+    Offset place = head->sentinel.prev;
+    Node* item = At(place);
+    ID = item->label;
+    Data = item->value;
+    head->sentinel.prev = item->prev;
+    At(item->prev)->next = SentinelOffset();
+    head->size--;
+    this->Release(place);
+    return true;
+}
+
+
+//This function removes the first element in the Ring and copies its key and info out, waiting for another process or thread to add one if the Ring is empty. It returns false
+//if the Ring is empty and closed, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::WaitPopFront(Key& ID, Info& Data){
+    Header* head = Head();
+    Guard locked(this);
+    while(head->size == 0 && !head->closed) this->Wait(nullptr);
+    if(head->size == 0) return false;
+    this->TakeFront(ID,Data);
+    return true;
+}
+
+
+//This function removes the first element in the Ring and copies its key and info out, waiting at most the given number of milliseconds for another process or thread to
+//add one if the Ring is empty. It returns false if the time ran out or the Ring is empty and closed, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::WaitPopFront(Key& ID, Info& Data, unsigned int milliseconds){
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC,&deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += static_cast<long>(milliseconds % 1000) * 1000000;
+    if(deadline.tv_nsec >= 1000000000){
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    Header* head = Head();
+    Guard locked(this);
+    while(head->size == 0 && !head->closed){
+        if(!this->Wait(&deadline)) break;
+    }
+    if(head->size == 0) return false;
+    this->TakeFront(ID,Data);
+    return true;
+}
+
+
+//This function closes the Ring, so pushes fail from then on and consumers waiting on an empty Ring return false. Elements already in the Ring can still be popped.
+template<typename Key, typename Info>
+void SharedRing<Key,Info>::Close(){
+    Header* head = Head();
+    Guard locked(this);
+    head->closed = 1;
+    pthread_cond_broadcast(&head->filled);
+}
+
+
+//This function waits for the Ring to be filled or closed, until the deadline if one is given. The lock must be held. It returns false if the deadline passed, and true otherwise.
+template<typename Key, typename Info>
+bool SharedRing<Key,Info>::Wait(const timespec* deadline) const{
+    Header* head = Head();
+    int result = deadline ? pthread_cond_timedwait(&head->filled,&head->lock,deadline) : pthread_cond_wait(&head->filled,&head->lock);
+    if(result == EOWNERDEAD) this->Recover();
+    return result != ETIMEDOUT;
+}
+
+
+//This function repairs the Ring after a process died while holding its lock, possibly in the middle of adding or removing an element. The next links from the sentinel are
+//trusted up to the first one that doesn't point to a node; the prev links, the size and the pool are rebuilt from them. The lock must be held.
+template<typename Key, typename Info>
+void SharedRing<Key,Info>::Recover() const{
+    Header* head = Head();
+    Offset sentinel = SentinelOffset();
+    Offset first = sizeof(Header);
+    std::vector<bool> Linked(head->capacity,false);
+
+    Offset previous = sentinel;
+    uint64_t size = 0;
+    Offset place = head->sentinel.next;
+    while(place != sentinel && size < head->capacity){
+        if(place < first || (place - first) % sizeof(Node) != 0 || (place - first) / sizeof(Node) >= head->capacity) break;
+        uint64_t slot = (place - first) / sizeof(Node);
+        if(Linked[slot]) break;
+        Linked[slot] = true;
+        At(place)->prev = previous;
+        previous = place;
+        place = At(place)->next;
+        size++;
+    }
+    At(previous)->next = sentinel;
+    head->sentinel.prev = previous;
+    head->size = size;
+
+    head->freeList = 0;
+    for(uint64_t i=head->capacity; i>0 ;i--){
+        if(Linked[i - 1]) continue;
+        At(first + (i - 1) * sizeof(Node))->next = head->freeList;
+        head->freeList = first + (i - 1) * sizeof(Node);
+    }
+
+    pthread_mutex_consistent(&head->lock);
+}
+
+
+
+#endif // SHM_RING